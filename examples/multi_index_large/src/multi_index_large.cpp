@@ -25,40 +25,33 @@ void multi_index_large::print( uint64_t id ) {
 [[eosio::action]] 
 void multi_index_large::byf( double f64 ) {
    auto idx = testtab.get_index<"byf"_n>();
-   for ( auto itr = idx.begin(); itr != idx.end(); itr++ ) {
-      if( itr->f64 == f64) {
-         print( itr->id );
-      }
+   // walks the index keys only, rows are loaded by print for the matches
+   for ( auto itr = idx.key_lower_bound(f64); itr != idx.key_end() && itr.secondary_key() == f64; ++itr ) {
+      print( itr.primary_key() );
    }
 }
 
 [[eosio::action]] 
 void multi_index_large::byff( long double f128 ) {
    auto idx = testtab.get_index<"byff"_n>();
-   for ( auto itr = idx.begin(); itr != idx.end(); itr++ ) {
-      if( itr->f128 == f128) {
-         print( itr->id );
-      }
+   for ( auto itr = idx.key_lower_bound(f128); itr != idx.key_end() && itr.secondary_key() == f128; ++itr ) {
+      print( itr.primary_key() );
    }
 }
 
 [[eosio::action]] 
 void multi_index_large::byuuuu( uint128_t u128 ) {
    auto idx = testtab.get_index<"byuuuu"_n>();
-   for ( auto itr = idx.begin(); itr != idx.end(); itr++ ) {
-      if( itr->u128 == u128 ) {  
-         print( itr->id );
-      }
+   for ( auto itr = idx.key_lower_bound(u128); itr != idx.key_end() && itr.secondary_key() == u128; ++itr ) {
+      print( itr.primary_key() );
    }
 }
 
 [[eosio::action]] 
 void multi_index_large::bychkb( eosio::checksum256 chk256 ) {
    auto idx = testtab.get_index<"bychkb"_n>();
-   for ( auto itr = idx.begin(); itr != idx.end(); itr++ ) {
-      if( itr->chk256 == chk256 ) {  
-         print( itr->id );
-      }
+   for ( auto itr = idx.key_lower_bound(chk256); itr != idx.key_end() && itr.secondary_key() == chk256; ++itr ) {
+      print( itr.primary_key() );
    }
 }
 
@@ -258,6 +258,51 @@ namespace eosio {
       return internal_use_do_not_use::is_account( n.value );
    }
 
+   namespace detail {
+
+      /// @cond INTERNAL
+
+      /// Action data that is already serialized, written out as is
+      struct packed_data {
+         const char* data;
+         size_t      size;
+      };
+
+      template<typename DataStream>
+      DataStream& operator<<( DataStream& ds, const packed_data& d ) {
+         ds.write( d.data, d.size );
+         return ds;
+      }
+
+      /**
+       * Serializes an action into a single buffer laid out like `pack(action)`, with `payload` as its data, and sends
+       * it inline. The size is computed up front, so the payload is written once and the buffer is on the stack
+       * unless the action is large.
+       */
+      template<typename T>
+      void send_packed( name account, name act, const std::vector<permission_level>& auths, const T& payload,
+                        bool context_free ) {
+         constexpr size_t max_stack_buffer_size = 512;
+         const size_t data_size = pack_size( payload );
+         const size_t size = pack_size( account ) + pack_size( act ) + pack_size( auths )
+                           + pack_size( unsigned_int(data_size) ) + data_size;
+
+         char* buffer = (char*)( max_stack_buffer_size < size ? malloc(size) : alloca(size) );
+         datastream<char*> ds( buffer, size );
+         ds << account << act << auths << unsigned_int(data_size) << payload;
+
+         if( context_free )
+            internal_use_do_not_use::send_context_free_inline( buffer, size );
+         else
+            internal_use_do_not_use::send_inline( buffer, size );
+
+         if( max_stack_buffer_size < size )
+            free( buffer );
+      }
+
+      /// @endcond
+   }
+
    /**
     *  This is the packed representation of an action along with
     *  meta-data about the authorization levels.
@@ -326,8 +371,7 @@ namespace eosio {
        * Send the action as inline action
        */
       void send() const {
-         auto serialize = pack(*this);
-         internal_use_do_not_use::send_inline(serialize.data(), serialize.size());
+         detail::send_packed( account, name, authorization, detail::packed_data{ data.data(), data.size() }, false );
       }
 
       /**
@@ -337,8 +381,7 @@ namespace eosio {
        */
       void send_context_free() const {
          eosio::check( authorization.size() == 0, "context free actions cannot have authorizations");
-         auto serialize = pack(*this);
-         internal_use_do_not_use::send_context_free_inline(serialize.data(), serialize.size());
+         detail::send_packed( account, name, authorization, detail::packed_data{ data.data(), data.size() }, true );
       }
 
       /**
@@ -482,14 +525,18 @@ namespace eosio {
          static_assert(detail::type_check<Action, Args...>());
          return action(permissions, code_name, action_name, detail::deduced<Action>{std::forward<Args>(args)...});
       }
+      /// Sends the action inline, serializing the arguments straight into the inline action rather than through to_action
       template <typename... Args>
       void send(Args&&... args)const {
-         to_action(std::forward<Args>(args)...).send();
+         static_assert(detail::type_check<Action, Args...>());
+         detail::send_packed(code_name, action_name, permissions, detail::deduced<Action>{std::forward<Args>(args)...}, false);
       }
 
       template <typename... Args>
       void send_context_free(Args&&... args)const {
-         to_action(std::forward<Args>(args)...).send_context_free();
+         static_assert(detail::type_check<Action, Args...>());
+         eosio::check( permissions.size() == 0, "context free actions cannot have authorizations");
+         detail::send_packed(code_name, action_name, permissions, detail::deduced<Action>{std::forward<Args>(args)...}, true);
       }
 
    };
@@ -531,12 +578,17 @@ namespace eosio {
 
       template <size_t Variant, typename... Args>
       void send(Args&&... args)const {
-         to_action<Variant>(std::forward<Args>(args)...).send();
+         static_assert(detail::type_check<detail::get_nth<Variant, Actions...>::value, Args...>());
+         unsigned_int var = Variant;
+         detail::send_packed(code_name, action_name, permissions, std::tuple_cat(std::make_tuple(var), detail::deduced<detail::get_nth<Variant, Actions...>::value>{std::forward<Args>(args)...}), false);
       }
 
       template <size_t Variant, typename... Args>
       void send_context_free(Args&&... args) const {
-         to_action<Variant>(std::forward<Args>(args)...).send_context_free();
+         static_assert(detail::type_check<detail::get_nth<Variant, Actions...>::value, Args...>());
+         eosio::check( permissions.size() == 0, "context free actions cannot have authorizations");
+         unsigned_int var = Variant;
+         detail::send_packed(code_name, action_name, permissions, std::tuple_cat(std::make_tuple(var), detail::deduced<detail::get_nth<Variant, Actions...>::value>{std::forward<Args>(args)...}), true);
       }
 
    };
@@ -545,7 +597,7 @@ namespace eosio {
    void dispatch_inline( name code, name act,
                          std::vector<permission_level> perms,
                          std::tuple<Args...> args ) {
-      action( perms, code, act, std::move(args) ).send();
+      detail::send_packed( code, act, perms, args, false );
    }
 
    template<typename, name::raw>
@@ -9,6 +9,8 @@
 #include <algorithm>
 #include <cctype>
 #include <functional>
+#include <iterator>
+#include <limits>
 #include <string_view>
 
 /**
@@ -436,7 +438,11 @@ namespace eosio::kv {
             return prfx;
          }
 
-         static key_type full_key(const key_t& k) { return prefix() + convert_to_key(k); }
+         static key_type full_key(const key_t& k) {
+            key_type fk = prefix();
+            convert_to_key(k, fk);
+            return fk;
+         }
 
          using elem_t = detail::elem<self_t>;
          using iterator_t = detail::iterator<false, self_t>;
@@ -593,11 +599,103 @@ namespace eosio::kv {
 
          std::pair<iterator_t, iterator_t> equal_range(const key_t& k) const { return {lower_bound(k), upper_bound(k)}; }
 
+         /**
+          * @ingroup keyvaluemap
+          *
+          * @brief A lazily evaluated, single pass view over the elements of the map within a key range.
+          * @details Elements are read and unpacked one at a time as the view is iterated, through the map's scratch
+          * buffer, so stopping early never pays for elements past that point.  At most `limit` elements are produced.
+          * The referenced element is overwritten when the view advances.
+          */
+         class slice_view {
+            public:
+               class iterator {
+                  public:
+                     using iterator_category = std::input_iterator_tag;
+                     using value_type        = elem_t;
+                     using difference_type   = std::ptrdiff_t;
+                     using pointer           = const elem_t*;
+                     using reference         = const elem_t&;
+
+                     iterator() = default;
+                     explicit iterator(slice_view* view) : view(view) {}
+
+                     const elem_t& operator*() const { return view->current(); }
+                     const elem_t* operator->() const { return &view->current(); }
+
+                     iterator& operator++() {
+                        view->advance();
+                        return *this;
+                     }
+
+                     bool operator==(const iterator& o) const { return at_end() == o.at_end(); }
+                     bool operator!=(const iterator& o) const { return at_end() != o.at_end(); }
+
+                  private:
+                     bool at_end() const { return view == nullptr || view->done; }
+
+                     slice_view* view = nullptr;
+               };
+
+               slice_view(iterator_t&& cursor, key_type end_key, std::size_t limit)
+                  : cursor(std::move(cursor)), end_key(std::move(end_key)), remaining(limit) {
+                  check_done();
+               }
+
+               slice_view(slice_view&&) = default;
+
+               iterator begin() { return iterator{this}; }
+               iterator end() { return iterator{}; }
+
+               bool empty() const { return done; }
+
+            private:
+               const elem_t& current() {
+                  check(!done, "reading past the end of a slice");
+                  if (!loaded) {
+                     cursor.materialize();
+                     loaded = true;
+                  }
+                  return cursor.element;
+               }
+
+               void advance() {
+                  check(!done, "incrementing past end of a slice");
+                  ++cursor;
+                  --remaining;
+                  loaded = false;
+                  check_done();
+               }
+
+               void check_done() {
+                  done = remaining == 0 || !cursor.is_valid() ||
+                         detail::itr_key_compare(cursor.handle, {end_key.data(), end_key.size()}) >= 0;
+               }
+
+               iterator_t  cursor;
+               key_type    end_key;
+               std::size_t remaining;
+               bool        loaded = false;
+               bool        done   = false;
+         };
+
+         /**
+          * @ingroup keyvaluemap
+          *
+          * @brief Returns a lazy view of the elements with keys in [l, h), reading each one only when it is reached.
+          * @param l The lowest key of the slice (inclusive).
+          * @param h The highest key of the slice (exclusive).
+          * @param limit The maximum number of elements the view will produce.
+          */
+         slice_view ranged_view(const key_t& l, const key_t& h, std::size_t limit = std::numeric_limits<std::size_t>::max()) const {
+            return slice_view{lower_bound(l), full_key(h), limit};
+         }
+
          std::vector<elem_t> ranged_slice(const key_t& l, const key_t& h) {
             std::vector<elem_t> ret;
 
-            for (auto itr = lower_bound(l); itr != lower_bound(h); ++itr) {
-               ret.emplace_back(std::move(*itr));
+            for (const auto& e : ranged_view(l, h)) {
+               ret.push_back(e);
             }
 
             return ret;
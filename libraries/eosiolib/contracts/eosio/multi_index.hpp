@@ -240,6 +240,40 @@ struct const_mem_fun
   }
 };
 
+/**
+ * Key extractor reading a data member of the row, the data member counterpart of const_mem_fun.
+ *
+ * Unlike a member function, the data member a key is read from is known at compile time, which lets
+ * `multi_index::modify_fields` skip the indices a modification cannot affect.
+ */
+template<class Class,typename Type,Type Class::*PtrToMember>
+struct member
+{
+  typedef Type result_type;
+
+  template<typename ChainedPtr>
+
+  auto operator()(const ChainedPtr& x)const -> std::enable_if_t<!std::is_convertible<const ChainedPtr&, const Class&>::value, const Type&>
+  {
+    return operator()(*x);
+  }
+
+  const Type& operator()(const Class& x)const
+  {
+    return x.*PtrToMember;
+  }
+
+  const Type& operator()(const std::reference_wrapper<const Class>& x)const
+  {
+    return operator()(x.get());
+  }
+
+  const Type& operator()(const std::reference_wrapper<Class>& x)const
+  {
+    return operator()(x.get());
+  }
+};
+
 #define WRAP_SECONDARY_SIMPLE_TYPE(IDX, TYPE)\
 template<>\
 struct secondary_index_db_functions<TYPE> {\
@@ -301,10 +335,135 @@ struct secondary_key_traits<TYPE> {\
    static constexpr TYPE true_lowest() { return std::numeric_limits<TYPE>::lowest(); }\
 };
 
+/**
+ * @ingroup multiindex
+ *
+ * Cache policy keeping every row loaded through a multi_index table object until the object is destroyed. This is
+ * the default policy.
+ */
+struct unbounded_cache {};
+
+/**
+ * @ingroup multiindex
+ *
+ * Cache policy keeping at most `MaxRows` of the rows loaded through a multi_index table object that no iterator points
+ * to. When another row is loaded, the least recently used of them are dropped; rows iterators point to are never
+ * dropped. Scans over large tables then use a bounded amount of memory.
+ *
+ * A reference to a row, as returned by `get` or by dereferencing an iterator, stays valid while an iterator points to
+ * the row, and otherwise at least until `MaxRows` other rows have been loaded.
+ *
+ * Example:
+ *
+ * @code
+ * multi_index<"mytable"_n, record,
+ *            indexed_by< "bysecondary"_n, const_mem_fun<record, uint128_t, &record::get_secondary> >,
+ *            lru_cache<64> > table( code, scope );
+ * @endcode
+ */
+template<uint32_t MaxRows>
+struct lru_cache {};
+
+/**
+ * @ingroup multiindex
+ *
+ * Cache policy keeping only the rows iterators point to and the most recently loaded row. A reference to a row that no
+ * iterator points to is invalidated when the next row is loaded.
+ */
+using no_cache = lru_cache<0>;
+
 namespace _multi_index_detail {
 
    namespace hana = boost::hana;
 
+   template<typename Arg>
+   struct cache_policy_traits {
+      static constexpr bool is_policy = false;
+   };
+
+   template<>
+   struct cache_policy_traits<unbounded_cache> {
+      static constexpr bool     is_policy = true;
+      static constexpr bool     bounded   = false;
+      static constexpr uint32_t max_rows  = 0;
+   };
+
+   template<uint32_t MaxRows>
+   struct cache_policy_traits<lru_cache<MaxRows>> {
+      static constexpr bool     is_policy = true;
+      static constexpr bool     bounded   = true;
+      static constexpr uint32_t max_rows  = MaxRows;
+   };
+
+   /// the cache policy among the index arguments of multi_index, unbounded_cache if there is none
+   template<typename... Args>
+   struct find_cache_policy {
+      typedef unbounded_cache type;
+   };
+
+   template<typename Arg, typename... Args>
+   struct find_cache_policy<Arg, Args...> {
+      typedef std::conditional_t<cache_policy_traits<Arg>::is_policy, Arg, typename find_cache_policy<Args...>::type> type;
+   };
+
+   /// the index arguments of multi_index other than the cache policy, appended to the hana::tuple `Kept`
+   template<typename Kept, typename... Args>
+   struct drop_cache_policy {
+      typedef Kept type;
+   };
+
+   template<typename... Kept, typename Arg, typename... Args>
+   struct drop_cache_policy<hana::tuple<Kept...>, Arg, Args...>
+      : drop_cache_policy<std::conditional_t<cache_policy_traits<Arg>::is_policy, hana::tuple<Kept...>, hana::tuple<Kept..., Arg>>, Args...> {};
+
+   /// State a bounded cache keeps in each cached row
+   struct lru_node {
+      mutable const lru_node* __lru_prev = nullptr;
+      mutable const lru_node* __lru_next = nullptr;
+      mutable uint32_t        __pins     = 0;     ///< number of iterators pointing to the row
+      mutable bool            __erased   = false; ///< erased while iterators pointed to it
+   };
+
+   struct no_lru_node {};
+
+   /**
+    * Intrusive list of the cached rows of a bounded cache no iterator points to, most recently used first.
+    */
+   class lru_list {
+      public:
+         void push_front( const lru_node* n ) {
+            n->__lru_prev = nullptr;
+            n->__lru_next = _head;
+            if( _head )
+               _head->__lru_prev = n;
+            else
+               _tail = n;
+            _head = n;
+            ++_size;
+         }
+
+         void remove( const lru_node* n ) {
+            if( n->__lru_prev )
+               n->__lru_prev->__lru_next = n->__lru_next;
+            else
+               _head = n->__lru_next;
+            if( n->__lru_next )
+               n->__lru_next->__lru_prev = n->__lru_prev;
+            else
+               _tail = n->__lru_prev;
+            n->__lru_prev = n->__lru_next = nullptr;
+            --_size;
+         }
+
+         const lru_node* back()const { return _tail; }
+         uint32_t size()const { return _size; }
+
+      private:
+         const lru_node* _head = nullptr;
+         const lru_node* _tail = nullptr;
+         uint32_t        _size = 0;
+   };
+
    template<typename T>
    struct secondary_index_db_functions;
 
@@ -335,6 +494,131 @@ namespace _multi_index_detail {
       static constexpr eosio::fixed_bytes<32> true_lowest() { return eosio::fixed_bytes<32>(); }
    };
 
+   template<auto A, auto B>
+   constexpr bool same_member() {
+      if constexpr( std::is_same_v<decltype(A), decltype(B)> )
+         return A == B;
+      else
+         return false;
+   }
+
+   /// Whether the key `Extractor` reads may change when only the data members `Members` of the row are modified
+   template<typename Extractor, auto... Members>
+   struct key_depends_on : std::true_type {};
+
+   template<class Class, typename Type, Type Class::*PtrToMember, auto... Members>
+   struct key_depends_on<member<Class, Type, PtrToMember>, Members...>
+      : std::bool_constant<(same_member<PtrToMember, Members>() || ...)> {};
+
+   /// Whether modify_fields compares the keys of the indices it skips and aborts if the updater changed one of them
+#ifdef NDEBUG
+   constexpr bool check_skipped_keys = false;
+#else
+   constexpr bool check_skipped_keys = true;
+#endif
+
+   /**
+    * Open-addressing hash map from a 64 bit key (a primary key or a primary iterator) to a slot in the
+    * multi_index object cache.
+    *
+    * Uses linear probing with backward-shift deletion, so erasing never leaves tombstones behind and lookups stay
+    * O(1) however many rows are loaded and erased during an action.
+    */
+   class item_cache_index {
+      public:
+         static constexpr uint32_t npos = static_cast<uint32_t>(-1);
+
+         uint32_t find( uint64_t key )const {
+            if( _size == 0 )
+               return npos;
+            for( size_t i = bucket(key);; i = (i + 1) & mask() ) {
+               const entry& e = _entries[i];
+               if( e.slot == npos )
+                  return npos;
+               if( e.key == key )
+                  return e.slot;
+            }
+         }
+
+         /// inserts the key or, if it is already present, points it at the new slot
+         void set( uint64_t key, uint32_t slot ) {
+            if( 2 * (_size + 1) > _entries.size() )
+               rehash( _entries.empty() ? 16 : _entries.size() * 2 );
+            for( size_t i = bucket(key);; i = (i + 1) & mask() ) {
+               entry& e = _entries[i];
+               if( e.slot == npos ) {
+                  e = {key, slot};
+                  ++_size;
+                  return;
+               }
+               if( e.key == key ) {
+                  e.slot = slot;
+                  return;
+               }
+            }
+         }
+
+         void erase( uint64_t key ) {
+            if( _size == 0 )
+               return;
+            size_t i = bucket(key);
+            for( ;; i = (i + 1) & mask() ) {
+               if( _entries[i].slot == npos )
+                  return;
+               if( _entries[i].key == key )
+                  break;
+            }
+            // shift back every following entry of the probe run that would otherwise become unreachable
+            for( size_t j = (i + 1) & mask(); _entries[j].slot != npos; j = (j + 1) & mask() ) {
+               const size_t home = bucket( _entries[j].key );
+               const bool movable = ( i <= j ) ? ( home <= i || home > j ) : ( home <= i && home > j );
+               if( movable ) {
+                  _entries[i] = _entries[j];
+                  i = j;
+               }
+            }
+            _entries[i].slot = npos;
+            --_size;
+         }
+
+         void clear() {
+            std::vector<entry>().swap( _entries );
+            _size = 0;
+            _shift = 64;
+         }
+
+         size_t size()const { return _size; }
+
+      private:
+         struct entry {
+            uint64_t key;
+            uint32_t slot;
+         };
+
+         size_t mask()const { return _entries.size() - 1; }
+
+         size_t bucket( uint64_t key )const {
+            // fibonacci hashing, the low bits of names and sequential keys are poorly distributed
+            return static_cast<size_t>( (key * 0x9E3779B97F4A7C15ULL) >> _shift );
+         }
+
+         void rehash( size_t capacity ) {
+            std::vector<entry> old( capacity, entry{0, npos} );
+            old.swap( _entries );
+            _size  = 0;
+            _shift = 64;
+            for( size_t c = capacity; c > 1; c >>= 1 )
+               --_shift;
+            for( const auto& e : old )
+               if( e.slot != npos )
+                  set( e.key, e.slot );
+         }
+
+         std::vector<entry> _entries;
+         size_t             _size  = 0;
+         uint32_t           _shift = 64;
+   };
+
 }
 
 /**
@@ -391,7 +675,8 @@ struct indexed_by {
  *
  * @tparam TableName - name of the table
  * @tparam T - type of the data stored inside the table
- * @tparam Indices - secondary indices for the table, up to 16 indices is supported here
+ * @tparam Indices - secondary indices for the table, up to 16 indices is supported here, optionally followed by the
+ * cache policy of the table object, one of `unbounded_cache` (the default), `lru_cache<N>` and `no_cache`
  *
  * Example:
  *
@@ -436,7 +721,13 @@ class multi_index
 {
    private:
 
-      static_assert( sizeof...(Indices) <= 16, "multi_index only supports a maximum of 16 secondary indices" );
+      typedef typename _multi_index_detail::find_cache_policy<Indices...>::type cache_policy;
+      typedef _multi_index_detail::cache_policy_traits<cache_policy>             cache_traits;
+
+      constexpr static size_t num_indices = sizeof...(Indices) - (size_t(_multi_index_detail::cache_policy_traits<Indices>::is_policy) + ... + 0);
+
+      static_assert( sizeof...(Indices) - num_indices <= 1, "multi_index takes at most one cache policy" );
+      static_assert( num_indices <= 16, "multi_index only supports a maximum of 16 secondary indices" );
 
       constexpr static bool validate_table_name( name n ) {
          // Limit table names to 12 characters so that the last character (4 bits) can be used to distinguish between the secondary indices.
@@ -457,7 +748,7 @@ class multi_index
          unset_next_primary_key = static_cast<uint64_t>(-1)
       };
 
-      struct item : public T
+      struct item : public T, public std::conditional_t<cache_traits::bounded, _multi_index_detail::lru_node, _multi_index_detail::no_lru_node>
       {
          template<typename Constructor>
          item( const multi_index* idx, Constructor&& c )
@@ -467,7 +758,7 @@ class multi_index
 
          const multi_index* __idx;
          int32_t            __primary_itr;
-         int32_t            __iters[sizeof...(Indices)+(sizeof...(Indices)==0)];
+         int32_t            __iters[num_indices+(num_indices==0)];
       };
 
       struct item_ptr
@@ -481,6 +772,120 @@ class multi_index
       };
 
       mutable std::vector<item_ptr> _items_vector;
+      mutable _multi_index_detail::item_cache_index _items_by_primary_key;
+      mutable _multi_index_detail::item_cache_index _items_by_primary_itr;
+
+      // with a bounded cache policy, the cached rows no iterator points to and the erased rows iterators still point to
+      mutable _multi_index_detail::lru_list      _lru;
+      mutable std::vector<std::unique_ptr<item>> _erased_items;
+
+      static uint64_t primary_itr_key( int32_t itr ) { return static_cast<uint32_t>(itr); }
+
+      // the most recently used row is always kept, for the reference `get` returns
+      constexpr static uint32_t max_unpinned_items = cache_traits::bounded && cache_traits::max_rows > 0 ? cache_traits::max_rows : 1;
+
+      /// drops the least recently used rows no iterator points to until at most `count` are left
+      void evict_items( uint32_t count )const {
+         while( _lru.size() > count )
+            uncache_item( static_cast<const item*>(_lru.back())->primary_key() );
+      }
+
+      const item* cache_item( std::unique_ptr<item>&& itm )const {
+         if constexpr( cache_traits::bounded )
+            evict_items( max_unpinned_items - 1 );
+
+         const item* ptr = itm.get();
+         auto pk   = itm->primary_key();
+         auto pitr = itm->__primary_itr;
+
+         const uint32_t slot = _items_vector.size();
+         _items_vector.emplace_back( std::move(itm), pk, pitr );
+         _items_by_primary_key.set( pk, slot );
+         _items_by_primary_itr.set( primary_itr_key(pitr), slot );
+
+         if constexpr( cache_traits::bounded )
+            _lru.push_front( ptr );
+
+         return ptr;
+      }
+
+      const item* find_cached_item( uint64_t pk )const {
+         auto slot = _items_by_primary_key.find( pk );
+         if( slot == _multi_index_detail::item_cache_index::npos )
+            return nullptr;
+         const item* ptr = _items_vector[slot]._item.get();
+         touch_item( ptr );
+         return ptr;
+      }
+
+      const item* find_cached_item_by_primary_itr( int32_t itr )const {
+         auto slot = _items_by_primary_itr.find( primary_itr_key(itr) );
+         if( slot == _multi_index_detail::item_cache_index::npos )
+            return nullptr;
+         const item* ptr = _items_vector[slot]._item.get();
+         touch_item( ptr );
+         return ptr;
+      }
+
+      /// takes the cached row with the given primary key out of the cache by moving the last cached row into its slot
+      std::unique_ptr<item> uncache_item( uint64_t pk )const {
+         auto slot = _items_by_primary_key.find( pk );
+         if( slot == _multi_index_detail::item_cache_index::npos )
+            return nullptr;
+
+         std::unique_ptr<item> itm = std::move( _items_vector[slot]._item );
+         if constexpr( cache_traits::bounded ) {
+            if( itm->__pins == 0 )
+               _lru.remove( itm.get() );
+         }
+
+         _items_by_primary_key.erase( pk );
+         _items_by_primary_itr.erase( primary_itr_key(_items_vector[slot]._primary_itr) );
+
+         const uint32_t last = _items_vector.size() - 1;
+         if( slot != last ) {
+            _items_vector[slot] = std::move( _items_vector[last] );
+            _items_by_primary_key.set( _items_vector[slot]._primary_key, slot );
+            _items_by_primary_itr.set( primary_itr_key(_items_vector[slot]._primary_itr), slot );
+         }
+         _items_vector.pop_back();
+         return itm;
+      }
+
+      /// moves a cached row no iterator points to to the front of the LRU list
+      void touch_item( const item* i )const {
+         if constexpr( cache_traits::bounded ) {
+            if( i->__pins == 0 ) {
+               _lru.remove( i );
+               _lru.push_front( i );
+            }
+         }
+      }
+
+      /// called by iterators when they start pointing to a row, which is then never dropped from the cache
+      static void pin_item( const item* i ) {
+         if constexpr( cache_traits::bounded ) {
+            if( i && i->__pins++ == 0 && !i->__erased )
+               i->__idx->_lru.remove( i );
+         }
+      }
+
+      /// called by iterators when they stop pointing to a row
+      static void unpin_item( const item* i ) {
+         if constexpr( cache_traits::bounded ) {
+            if( !i || --i->__pins != 0 )
+               return;
+            if( !i->__erased ) {
+               i->__idx->_lru.push_front( i );
+               i->__idx->evict_items( max_unpinned_items );
+               return;
+            }
+            auto& erased = i->__idx->_erased_items;
+            auto itr = std::find_if( erased.begin(), erased.end(), [&]( const auto& e ) { return e.get() == i; } );
+            std::swap( *itr, erased.back() );
+            erased.pop_back();
+         }
+      }
 
       template<name::raw IndexName, typename Extractor, uint64_t Number, bool IsConst>
       struct index {
@@ -544,14 +949,14 @@ class multi_index
                      uint64_t next_pk = 0;
                      auto next_itr = secondary_index_db_functions<secondary_key_type>::db_idx_next( _item->__iters[Number], &next_pk );
                      if( next_itr < 0 ) {
-                        _item = nullptr;
+                        set_item( nullptr );
                         return *this;
                      }
 
                      const T& obj = *_idx->_multidx->find( next_pk );
                      auto& mi = const_cast<item&>( static_cast<const item&>(obj) );
                      mi.__iters[Number] = next_itr;
-                     _item = &mi;
+                     set_item( &mi );
 
                      return *this;
                   }
@@ -581,21 +986,151 @@ class multi_index
                      const T& obj = *_idx->_multidx->find( prev_pk );
                      auto& mi = const_cast<item&>( static_cast<const item&>(obj) );
                      mi.__iters[Number] = prev_itr;
-                     _item = &mi;
+                     set_item( &mi );
 
                      return *this;
                   }
 
                   const_iterator():_item(nullptr){}
+
+                  const_iterator( const const_iterator& other )
+                  : _idx(other._idx), _item(other._item) {
+                     pin_item( _item );
+                  }
+
+                  const_iterator& operator=( const const_iterator& other ) {
+                     _idx = other._idx;
+                     set_item( other._item );
+                     return *this;
+                  }
+
+                  ~const_iterator() { unpin_item( _item ); }
                private:
                   friend struct index;
                   const_iterator( const index* idx, const item* i = nullptr )
-                  : _idx(idx), _item(i) {}
+                  : _idx(idx), _item(i) {
+                     pin_item( _item );
+                  }
+
+                  void set_item( const item* i ) {
+                     pin_item( i );
+                     unpin_item( _item );
+                     _item = i;
+                  }
 
                   const index* _idx;
                   const item*  _item;
             }; /// struct multi_index::index::const_iterator
 
+            /**
+             * Iterator over the (secondary key, primary key) pairs of the index that does not load rows.
+             *
+             * Stepping costs a single `db_idx_next`/`db_idx_previous` call; the secondary key is read from the index
+             * table the first time it is asked for, and the row is only loaded when the iterator is dereferenced.
+             * Scans that only compare keys should use it rather than const_iterator, which loads every row it visits.
+             *
+             * Like the underlying database iterator, it is invalidated by erasing or re-keying the row it points to.
+             */
+            struct key_iterator : public std::iterator<std::bidirectional_iterator_tag, const T> {
+               public:
+                  friend bool operator == ( const key_iterator& a, const key_iterator& b ) {
+                     return a._itr == b._itr;
+                  }
+                  friend bool operator != ( const key_iterator& a, const key_iterator& b ) {
+                     return a._itr != b._itr;
+                  }
+
+                  uint64_t primary_key()const {
+                     eosio::check( _itr >= 0, "cannot read the key of an end iterator" );
+                     return _primary;
+                  }
+
+                  const secondary_key_type& secondary_key()const {
+                     using namespace _multi_index_detail;
+
+                     eosio::check( _itr >= 0, "cannot read the key of an end iterator" );
+                     if( !_has_secondary ) {
+                        if( const item* cached = _idx->_multidx->find_cached_item( _primary ) ) {
+                           _secondary = secondary_extractor_type()( *cached );
+                        } else {
+                           secondary_index_db_functions<secondary_key_type>::db_idx_find_primary( _idx->get_code().value, _idx->get_scope(), _idx->name(), _primary, _secondary );
+                        }
+                        _has_secondary = true;
+                     }
+                     return _secondary;
+                  }
+
+                  const T& operator*()const {
+                     eosio::check( _itr >= 0, "cannot dereference end iterator" );
+                     const T& obj = _idx->_multidx->get( _primary );
+                     auto& mi = const_cast<item&>( static_cast<const item&>(obj) );
+                     mi.__iters[Number] = _itr;
+                     return obj;
+                  }
+                  const T* operator->()const { return &**this; }
+
+                  key_iterator operator++(int){
+                     key_iterator result(*this);
+                     ++(*this);
+                     return result;
+                  }
+
+                  key_iterator operator--(int){
+                     key_iterator result(*this);
+                     --(*this);
+                     return result;
+                  }
+
+                  key_iterator& operator++() {
+                     using namespace _multi_index_detail;
+
+                     eosio::check( _itr >= 0, "cannot increment end iterator" );
+
+                     uint64_t next_pk = 0;
+                     auto next_itr = secondary_index_db_functions<secondary_key_type>::db_idx_next( _itr, &next_pk );
+                     set( next_itr < 0 ? -1 : next_itr, next_pk );
+                     return *this;
+                  }
+
+                  key_iterator& operator--() {
+                     using namespace _multi_index_detail;
+
+                     uint64_t prev_pk = 0;
+                     int32_t  prev_itr = -1;
+
+                     if( _itr < 0 ) {
+                        auto ei = secondary_index_db_functions<secondary_key_type>::db_idx_end(_idx->get_code().value, _idx->get_scope(), _idx->name());
+                        eosio::check( ei != -1, "cannot decrement end iterator when the index is empty" );
+                        prev_itr = secondary_index_db_functions<secondary_key_type>::db_idx_previous( ei, &prev_pk );
+                        eosio::check( prev_itr >= 0, "cannot decrement end iterator when the index is empty" );
+                     } else {
+                        prev_itr = secondary_index_db_functions<secondary_key_type>::db_idx_previous( _itr, &prev_pk );
+                        eosio::check( prev_itr >= 0, "cannot decrement iterator at beginning of index" );
+                     }
+
+                     set( prev_itr, prev_pk );
+                     return *this;
+                  }
+
+                  key_iterator():_idx(nullptr),_itr(-1),_primary(0){}
+               private:
+                  friend struct index;
+                  key_iterator( const index* idx, int32_t itr = -1, uint64_t primary = 0 )
+                  : _idx(idx), _itr(itr), _primary(primary) {}
+
+                  void set( int32_t itr, uint64_t primary ) {
+                     _itr = itr;
+                     _primary = primary;
+                     _has_secondary = false;
+                  }
+
+                  const index*               _idx;
+                  int32_t                    _itr;
+                  uint64_t                   _primary;
+                  mutable secondary_key_type _secondary{};
+                  mutable bool               _has_secondary = false;
+            }; /// struct multi_index::index::key_iterator
+
             typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
 
             const_iterator cbegin()const {
@@ -699,6 +1234,43 @@ class multi_index
 
                return {this, &mi};
             }
+            key_iterator key_begin()const {
+               using namespace _multi_index_detail;
+               return key_lower_bound( secondary_key_traits<secondary_key_type>::true_lowest() );
+            }
+
+            key_iterator key_end()const { return key_iterator( this ); }
+
+            key_iterator key_lower_bound( const secondary_key_type& secondary )const {
+               using namespace _multi_index_detail;
+
+               uint64_t primary = 0;
+               key_iterator result( this );
+               result._secondary = secondary;
+               auto itr = secondary_index_db_functions<secondary_key_type>::db_idx_lowerbound( get_code().value, get_scope(), name(), result._secondary, primary );
+               if( itr < 0 ) return key_end();
+
+               result._itr = itr;
+               result._primary = primary;
+               result._has_secondary = true;
+               return result;
+            }
+
+            key_iterator key_upper_bound( const secondary_key_type& secondary )const {
+               using namespace _multi_index_detail;
+
+               uint64_t primary = 0;
+               key_iterator result( this );
+               result._secondary = secondary;
+               auto itr = secondary_index_db_functions<secondary_key_type>::db_idx_upperbound( get_code().value, get_scope(), name(), result._secondary, primary );
+               if( itr < 0 ) return key_end();
+
+               result._itr = itr;
+               result._primary = primary;
+               result._has_secondary = true;
+               return result;
+            }
+
             /**
              * Warning: the interator_to can have undefined behavior if the caller 
              * passes in a reference to a stack-allocated object rather than the 
@@ -767,7 +1339,7 @@ class multi_index
                              hana::make_tuple( intc<0>(), intc<1>(), intc<2>(), intc<3>(), intc<4>(), intc<5>(),
                                                intc<6>(), intc<7>(), intc<8>(), intc<9>(), intc<10>(), intc<11>(),
                                                intc<12>(), intc<13>(), intc<14>(), intc<15>() ),
-                             hana::tuple<Indices...>() ) ) indices_input_type;
+                             typename drop_cache_policy<hana::tuple<>, Indices...>::type() ) ) indices_input_type;
 
          return hana::transform( indices_input_type(), [&]( auto&& idx ){
              typedef typename std::decay<decltype(hana::at_c<0>(idx))>::type num_type;
@@ -789,11 +1361,8 @@ class multi_index
       const item& load_object_by_primary_iterator( int32_t itr )const {
          using namespace _multi_index_detail;
 
-         auto itr2 = std::find_if(_items_vector.rbegin(), _items_vector.rend(), [&](const item_ptr& ptr) {
-            return ptr._primary_itr == itr;
-         });
-         if( itr2 != _items_vector.rend() )
-            return *itr2->_item;
+         if( const item* cached = find_cached_item_by_primary_itr( itr ) )
+            return *cached;
 
          auto size = internal_use_do_not_use::db_get_i64( itr, nullptr, 0 );
          eosio::check( size >= 0, "error reading iterator" );
@@ -817,11 +1386,7 @@ class multi_index
             });
          });
 
-         const item* ptr = itm.get();
-         auto pk   = itm->primary_key();
-         auto pitr = itm->__primary_itr;
-
-         _items_vector.emplace_back( std::move(itm), pk, pitr );
+         const item* ptr = cache_item( std::move(itm) );
 
          if ( max_stack_buffer_size < size_t(size) ) {
             free(buffer);
@@ -851,6 +1416,7 @@ class multi_index
        * - Each must be a default constructable class or struct
        * - Each must have a function call operator that takes a const reference to the table object type and returns either a secondary key type or a reference to a secondary key type
        * - It is recommended to use the eosio::const_mem_fun template, which is a type alias to the boost::multi_index::const_mem_fun.  See the documentation for the Boost const_mem_fun key extractor for more details.
+       * - `Indices` may also include one cache policy, `eosio::unbounded_cache` (the default), `eosio::lru_cache<N>` or `eosio::no_cache`, which bounds how many loaded rows the table object keeps.
        *
        * Example:
        *
@@ -953,9 +1519,9 @@ class multi_index
             uint64_t next_pk;
             auto next_itr = internal_use_do_not_use::db_next_i64( _item->__primary_itr, &next_pk );
             if( next_itr < 0 )
-               _item = nullptr;
+               set_item( nullptr );
             else
-               _item = &_multidx->load_object_by_primary_iterator( next_itr );
+               set_item( &_multidx->load_object_by_primary_iterator( next_itr ) );
             return *this;
          }
          const_iterator& operator--() {
@@ -972,13 +1538,34 @@ class multi_index
                eosio::check( prev_itr >= 0, "cannot decrement iterator at beginning of table" );
             }
 
-            _item = &_multidx->load_object_by_primary_iterator( prev_itr );
+            set_item( &_multidx->load_object_by_primary_iterator( prev_itr ) );
             return *this;
          }
 
+         const_iterator( const const_iterator& other )
+         :_multidx(other._multidx),_item(other._item) {
+            pin_item( _item );
+         }
+
+         const_iterator& operator=( const const_iterator& other ) {
+            _multidx = other._multidx;
+            set_item( other._item );
+            return *this;
+         }
+
+         ~const_iterator() { unpin_item( _item ); }
+
          private:
             const_iterator( const multi_index* mi, const item* i = nullptr )
-            :_multidx(mi),_item(i){}
+            :_multidx(mi),_item(i) {
+               pin_item( _item );
+            }
+
+            void set_item( const item* i ) {
+               pin_item( i );
+               unpin_item( _item );
+               _item = i;
+            }
 
             const multi_index* _multidx;
             const item*        _item;
@@ -1589,15 +2176,113 @@ class multi_index
             });
          });
 
-         const item* ptr = itm.get();
-         auto pk   = itm->primary_key();
-         auto pitr = itm->__primary_itr;
-
-         _items_vector.emplace_back( std::move(itm), pk, pitr );
+         const item* ptr = cache_item( std::move(itm) );
 
          return {this, ptr};
       }
 
+      /**
+       * Adds the rows in the range [first, last) to the table.
+       * @ingroup multiindex
+       *
+       * @details Meant for loading many rows in one action, such as migrations and airdrops. Every row is serialized
+       * into the same buffer, and unlike `emplace` the new rows are not kept in the table object's cache, so the
+       * memory used stays flat however many rows are added. A row added this way is read back from the database the
+       * first time it is looked up.
+       *
+       * @param payer - Account name of the payer for the Storage usage of the new objects
+       * @param first - Iterator to the first row to add
+       * @param last - Iterator past the last row to add
+       *
+       * @pre No row in the range has the primary key of a row already in the table
+       * @post The rows are serialized and written to the table and secondary indices are updated to refer to them
+       *
+       * Example:
+       *
+       * @code
+       * std::vector<address> rows = read_rows();
+       * addresses.emplace_many( _self, rows.begin(), rows.end() );
+       * @endcode
+       */
+      template<typename InputIterator>
+      void emplace_many( name payer, InputIterator first, InputIterator last ) {
+         eosio::check( _code == current_receiver(), "cannot create objects in table of another contract" );
+
+         std::vector<char> buffer;
+         for( ; first != last; ++first )
+            store_object( payer, *first, buffer );
+      }
+
+      /**
+       * Adds the rows of a range to the table without caching them.
+       * @ingroup multiindex
+       *
+       * @param payer - Account name of the payer for the Storage usage of the new objects
+       * @param rows - Range of the rows to add
+       *
+       * @see emplace_many( name, InputIterator, InputIterator )
+       */
+      template<typename Range>
+      void emplace_many( name payer, const Range& rows ) {
+         emplace_many( payer, std::begin(rows), std::end(rows) );
+      }
+
+      /**
+       * Adds `count` rows, each initialized by a lambda, to the table without caching them.
+       * @ingroup multiindex
+       *
+       * @details Rows are built one at a time, so they never all have to be in memory at once.
+       *
+       * @param payer - Account name of the payer for the Storage usage of the new objects
+       * @param count - Number of rows to add
+       * @param constructor - Lambda called as `constructor( obj, i )` to initialize a default constructed row for
+       * the i-th row to add
+       *
+       * @see emplace_many( name, InputIterator, InputIterator )
+       *
+       * Example:
+       *
+       * @code
+       * addresses.emplace_many( _self, recipients.size(), [&]( auto& address, size_t i ) {
+       *    address.account_name = recipients[i];
+       * });
+       * @endcode
+       */
+      template<typename Lambda>
+      void emplace_many( name payer, size_t count, Lambda&& constructor ) {
+         eosio::check( _code == current_receiver(), "cannot create objects in table of another contract" );
+
+         std::vector<char> buffer;
+         for( size_t i = 0; i < count; ++i ) {
+            T obj{};
+            constructor( obj, i );
+            store_object( payer, obj, buffer );
+         }
+      }
+
+      /**
+       * Drops the rows the table object has cached.
+       * @ingroup multiindex
+       *
+       * @details With the default `unbounded_cache` policy, rows loaded through the table object are cached until it
+       * is destroyed. An action going over more rows than fit in memory can drop them once they are no longer needed;
+       * rows are read back from the database when next looked up. With a bounded cache policy, only the rows no
+       * iterator points to are dropped.
+       *
+       * @post With the `unbounded_cache` policy, iterators and references to rows obtained from this table object
+       * before the call are invalidated. With a bounded policy, only the references to rows no iterator points to are.
+       */
+      void clear_cache() {
+         if constexpr( cache_traits::bounded ) {
+            while( _lru.size() > 0 )
+               uncache_item( static_cast<const item*>(_lru.back())->primary_key() );
+         } else {
+            std::vector<item_ptr>().swap( _items_vector );
+            _items_by_primary_key.clear();
+            _items_by_primary_itr.clear();
+         }
+      }
+
       /**
        * Modifies an existing object in a table.
        * @ingroup multiindex
@@ -1688,6 +2373,97 @@ class multi_index
        */
       template<typename Lambda>
       void modify( const T& obj, name payer, Lambda&& updater ) {
+         modify_impl<false>( obj, payer, std::forward<Lambda&&>(updater) );
+      }
+
+      /**
+       * Modifies an existing object in a table, given the data members the updater changes.
+       * @ingroup multiindex
+       *
+       * @details Works like `modify`, but only the secondary indices whose key may depend on one of `Members` are
+       * looked at. An index keyed by an `eosio::member` extractor on a data member that is not listed is skipped:
+       * its key is neither extracted nor compared. Indices keyed by other extractors, such as `const_mem_fun`, may
+       * read any member and are checked as `modify` does. The host calls made are the same as for `modify`, which
+       * already leaves the indices whose key did not change alone; what is saved is the key extraction and
+       * comparison in the contract.
+       *
+       * Unless `NDEBUG` is defined, the keys of the skipped indices are still compared after the updater ran and
+       * the transaction aborts if one of them changed, as that index would otherwise be left stale.
+       *
+       * @tparam Members - Pointers to the data members of T that the updater may change
+       * @param itr - an iterator pointing to the object to be updated
+       * @param payer - account name of the payer for the storage usage of the updated row
+       * @param updater - lambda function that updates the target object
+       *
+       * @pre The updater changes no data member of the object other than `Members`
+       *
+       * Example:
+       *
+       * @code
+       * using accounts = eosio::multi_index<"accounts"_n, account,
+       *    indexed_by<"balance"_n, eosio::member<account, uint64_t, &account::balance>>,
+       *    indexed_by<"owner"_n, eosio::member<account, uint64_t, &account::owner>>>;
+       *
+       * // only the balance index is updated
+       * table.modify_fields<&account::balance>( itr, same_payer, [&]( auto& a ) {
+       *    a.balance += quantity;
+       * });
+       * @endcode
+       */
+      template<auto... Members, typename Lambda>
+      void modify_fields( const_iterator itr, name payer, Lambda&& updater ) {
+         eosio::check( itr != end(), "cannot pass end iterator to modify" );
+
+         modify_fields<Members...>( *itr, payer, std::forward<Lambda&&>(updater) );
+      }
+
+      /**
+       * Modifies an existing object in a table, given the data members the updater changes.
+       * @ingroup multiindex
+       *
+       * @tparam Members - Pointers to the data members of T that the updater may change
+       * @param obj - a reference to the object to be updated
+       * @param payer - account name of the payer for the storage usage of the updated row
+       * @param updater - lambda function that updates the target object
+       *
+       * @pre The updater changes no data member of the object other than `Members`
+       */
+      template<auto... Members, typename Lambda>
+      void modify_fields( const T& obj, name payer, Lambda&& updater ) {
+         static_assert( (std::is_member_object_pointer_v<decltype(Members)> && ...), "modify_fields takes pointers to data members of the row" );
+
+         modify_impl<true, Members...>( obj, payer, std::forward<Lambda&&>(updater) );
+      }
+
+   private:
+      /// writes a row and its secondary keys to the database, serializing it into `buffer`
+      void store_object( name payer, const T& obj, std::vector<char>& buffer ) {
+         using namespace _multi_index_detail;
+
+         size_t size = pack_size( obj );
+         if( buffer.size() < size )
+            buffer.resize( size );
+
+         datastream<char*> ds( buffer.data(), size );
+         ds << obj;
+
+         auto pk = obj.primary_key();
+
+         internal_use_do_not_use::db_store_i64( _scope, static_cast<uint64_t>(TableName), payer.value, pk, buffer.data(), size );
+
+         if( pk >= _next_primary_key )
+            _next_primary_key = (pk >= no_available_primary_key) ? no_available_primary_key : (pk + 1);
+
+         hana::for_each( _indices, [&]( auto& idx ) {
+            typedef typename decltype(+hana::at_c<0>(idx))::type index_type;
+
+            secondary_index_db_functions<typename index_type::secondary_key_type>::db_idx_store( _scope, index_type::name(), payer.value, pk, index_type::extract_secondary_key(obj) );
+         });
+      }
+
+      /// modify, where Tracked says the updater only changes the data members `Members`
+      template<bool Tracked, auto... Members, typename Lambda>
+      void modify_impl( const T& obj, name payer, Lambda&& updater ) {
          using namespace _multi_index_detail;
 
          const auto& objitem = static_cast<const item&>(obj);
@@ -1698,7 +2474,10 @@ class multi_index
          auto secondary_keys = hana::transform( _indices, [&]( auto&& idx ) {
             typedef typename decltype(+hana::at_c<0>(idx))::type index_type;
 
-            return index_type::extract_secondary_key( obj );
+            if constexpr( !Tracked || check_skipped_keys || key_depends_on<typename index_type::secondary_extractor_type, Members...>::value )
+               return index_type::extract_secondary_key( obj );
+            else
+               return hana::nothing;
          });
 
          auto pk = obj.primary_key();
@@ -1708,6 +2487,18 @@ class multi_index
 
          eosio::check( pk == obj.primary_key(), "updater cannot change primary key when modifying an object" );
 
+         if constexpr( Tracked && check_skipped_keys ) {
+            hana::for_each( _indices, [&]( auto& idx ) {
+               typedef typename decltype(+hana::at_c<0>(idx))::type index_type;
+
+               if constexpr( !key_depends_on<typename index_type::secondary_extractor_type, Members...>::value ) {
+                  auto secondary = index_type::extract_secondary_key( obj );
+                  eosio::check( memcmp( &hana::at_c<index_type::index_number>(secondary_keys), &secondary, sizeof(secondary) ) == 0,
+                                "updater changed a data member not passed to modify_fields" );
+               }
+            });
+         }
+
          size_t size = pack_size( obj );
          //using malloc/free here potentially is not exception-safe, although WASM doesn't support exceptions
          void* buffer = max_stack_buffer_size < size ? malloc(size) : alloca(size);
@@ -1727,21 +2518,25 @@ class multi_index
          hana::for_each( _indices, [&]( auto& idx ) {
             typedef typename decltype(+hana::at_c<0>(idx))::type index_type;
 
-            auto secondary = index_type::extract_secondary_key( obj );
-            if( memcmp( &hana::at_c<index_type::index_number>(secondary_keys), &secondary, sizeof(secondary) ) != 0 ) {
-               auto indexitr = mutableitem.__iters[index_type::number()];
+            if constexpr( !Tracked || key_depends_on<typename index_type::secondary_extractor_type, Members...>::value ) {
+               auto secondary = index_type::extract_secondary_key( obj );
+               if( memcmp( &hana::at_c<index_type::index_number>(secondary_keys), &secondary, sizeof(secondary) ) != 0 ) {
+                  auto indexitr = mutableitem.__iters[index_type::number()];
 
-               if( indexitr < 0 ) {
-                  typename index_type::secondary_key_type temp_secondary_key;
-                  indexitr = mutableitem.__iters[index_type::number()]
-                           = secondary_index_db_functions<typename index_type::secondary_key_type>::db_idx_find_primary( _code.value, _scope, index_type::name(), pk,  temp_secondary_key );
-               }
+                  if( indexitr < 0 ) {
+                     typename index_type::secondary_key_type temp_secondary_key;
+                     indexitr = mutableitem.__iters[index_type::number()]
+                              = secondary_index_db_functions<typename index_type::secondary_key_type>::db_idx_find_primary( _code.value, _scope, index_type::name(), pk,  temp_secondary_key );
+                  }
 
-               secondary_index_db_functions<typename index_type::secondary_key_type>::db_idx_update( indexitr, payer.value, secondary );
+                  secondary_index_db_functions<typename index_type::secondary_key_type>::db_idx_update( indexitr, payer.value, secondary );
+               }
             }
          });
       }
 
+   public:
+
       /**
        * Retrieves an existing object from a table using its primary key.
        * @ingroup multiindex
@@ -1804,11 +2599,8 @@ class multi_index
        * @endcode
        */
       const_iterator find( uint64_t primary )const {
-         auto itr2 = std::find_if(_items_vector.rbegin(), _items_vector.rend(), [&](const item_ptr& ptr) {
-            return ptr._item->primary_key() == primary;
-         });
-         if( itr2 != _items_vector.rend() )
-            return iterator_to(*(itr2->_item));
+         if( const item* cached = find_cached_item( primary ) )
+            return iterator_to(*cached);
 
          auto itr = internal_use_do_not_use::db_find_i64( _code.value, _scope, static_cast<uint64_t>(TableName), primary );
          if( itr < 0 ) return end();
@@ -1827,11 +2619,8 @@ class multi_index
        */
 
       const_iterator require_find( uint64_t primary, const char* error_msg = "unable to find key" )const {
-         auto itr2 = std::find_if(_items_vector.rbegin(), _items_vector.rend(), [&](const item_ptr& ptr) {
-               return ptr._item->primary_key() == primary;
-            });
-         if( itr2 != _items_vector.rend() )
-            return iterator_to(*(itr2->_item));
+         if( const item* cached = find_cached_item( primary ) )
+            return iterator_to(*cached);
 
          auto itr = internal_use_do_not_use::db_find_i64( _code.value, _scope, static_cast<uint64_t>(TableName), primary );
          eosio::check( itr >= 0,  error_msg );
@@ -1927,11 +2716,7 @@ class multi_index
          eosio::check( _code == current_receiver(), "cannot erase objects in table of another contract" ); // Quick fix for mutating db using multi_index that shouldn't allow mutation. Real fix can come in RC2.
 
          auto pk = objitem.primary_key();
-         auto itr2 = std::find_if(_items_vector.rbegin(), _items_vector.rend(), [&](const item_ptr& ptr) {
-            return ptr._item->primary_key() == pk;
-         });
-
-         eosio::check( itr2 != _items_vector.rend(), "attempt to remove object that was not in multi_index" );
+         eosio::check( find_cached_item( pk ) != nullptr, "attempt to remove object that was not in multi_index" );
 
          internal_use_do_not_use::db_remove_i64( objitem.__primary_itr );
 
@@ -1947,7 +2732,14 @@ class multi_index
                secondary_index_db_functions<typename index_type::secondary_key_type>::db_idx_remove( i );
          });
 
-         _items_vector.erase(--(itr2.base()));
+         auto itm = uncache_item( pk );
+         if constexpr( cache_traits::bounded ) {
+            // iterators still pointing to the row keep it alive until they move on
+            if( itm->__pins != 0 ) {
+               itm->__erased = true;
+               _erased_items.push_back( std::move(itm) );
+            }
+         }
       }
 
 };
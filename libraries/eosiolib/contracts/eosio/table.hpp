@@ -8,6 +8,9 @@
 #include <algorithm>
 #include <cctype>
 #include <functional>
+#include <iterator>
+#include <limits>
+#include <vector>
 
 #warning "eosio::kv::table is designated as `alpha` and should not be used in production code"
 
@@ -69,12 +72,48 @@ inline key_type make_key(T&& t) {
 }
 
 inline key_type make_prefix(eosio::name table_name, eosio::name index_name, uint8_t status = 1) {
-   return make_key(std::make_tuple(status, table_name, index_name));
+   return eosio::detail::const_pack(status, table_name, index_name);
 }
 
 inline key_type table_key(const key_type& prefix, const key_type& key) {
    return prefix + key;
 }
+
+namespace detail {
+   constexpr inline size_t prefix_size = sizeof(uint8_t) + 2 * sizeof(eosio::name);
+
+   // A full table key (index prefix followed by the encoded key) built in place on the stack.
+   template <size_t N>
+   struct stack_key {
+      char     buffer[N];
+      uint32_t length = 0;
+
+      const char* data() const { return buffer; }
+      uint32_t size() const { return length; }
+   };
+
+   /**
+    * Builds the table key for `key` under `prefix`.  Keys whose encoding has a fixed upper bound are written into a
+    * stack buffer of that size, so point lookups do not touch the heap; everything else is appended to a copy of
+    * the prefix.
+    */
+   template <typename K>
+   inline auto make_table_key(const key_type& prefix, const K& key) {
+      constexpr size_t max_size = max_key_size<K>();
+      if constexpr (max_size == 0) {
+         key_type t_key = prefix;
+         convert_to_key(key, t_key);
+         return t_key;
+      } else {
+         stack_key<prefix_size + max_size> t_key;
+         memcpy(t_key.buffer, prefix.data(), prefix_size);
+         datastream<char*> ds(t_key.buffer + prefix_size, max_size);
+         to_key(key, ds);
+         t_key.length = prefix_size + ds.tellp();
+         return t_key;
+      }
+   }
+}
 /* @endcond */
 
 // This is the "best" way to document a function that does not technically exist using Doxygen.
@@ -112,22 +151,31 @@ namespace internal {
       eosio::name contract_name;
 
       key_type to_table_key(const key_type& k) const { return prefix + k; }
+      key_type get_table_key_void(const void* ptr) const {
+         key_type k = prefix;
+         key_function(ptr, k);
+         return k;
+      }
 
    protected:
       index_base() = default;
 
       template <typename KF, typename T>
       index_base(eosio::name index_name, KF&& kf, T*) : index_name{index_name} {
-         key_function = [=](const void* t) {
-            return make_key(std::invoke(kf, static_cast<const T*>(t)));
+         key_function = [=](const void* t, key_type& k) {
+            convert_to_key(std::invoke(kf, static_cast<const T*>(t)), k);
          };
       }
 
       template<typename T>
-      key_type get_key(const T& inst) const { return key_function(&inst); }
-      key_type get_key_void(const void* ptr) const { return key_function(ptr); }
+      key_type get_key(const T& inst) const { return get_key_void(&inst); }
+      key_type get_key_void(const void* ptr) const {
+         key_type k;
+         key_function(ptr, k);
+         return k;
+      }
 
-      void get(const key_type& key, void* ret_val, void (*deserialize)(void*, const void*, std::size_t)) const;
+      void get(const char* key, uint32_t key_size, void* ret_val, void (*deserialize)(void*, const void*, std::size_t)) const;
 
       table_base* tbl;
       key_type prefix;
@@ -138,7 +186,8 @@ namespace internal {
       friend class table_base;
       friend class iterator_base;
 
-      std::function<key_type(const void*)> key_function;
+      // appends the encoded key of the given value
+      std::function<void(const void*, key_type&)> key_function;
 
       virtual void setup() = 0;
    };
@@ -155,6 +204,30 @@ namespace internal {
       index_base* primary_index;
       std::vector<index_base*> secondary_indices;
 
+      // Fast path for tables without secondary indices: the previous value is never needed, so the row is
+      // overwritten without reading it back first.
+      void put_primary(const void* value,
+                       std::size_t (*get_size)(const void*),
+                       void (*serialize)(const void*, void*, std::size_t),
+                       eosio::name payer) {
+         auto tbl_key = primary_index->get_table_key_void(value);
+
+         size_t data_size = get_size(value);
+         void* data_buffer = data_size > detail::max_stack_buffer_size ? malloc(data_size) : alloca(data_size);
+
+         serialize(value, data_buffer, data_size);
+
+         internal_use_do_not_use::kv_set(contract_name.value, tbl_key.data(), tbl_key.size(), (const char*)data_buffer, data_size, payer.value);
+
+         if (data_size > detail::max_stack_buffer_size) {
+            free(data_buffer);
+         }
+      }
+
+      // Write path for tables with secondary indices.  The new value is serialized first so an update that leaves
+      // the stored bytes unchanged can skip the secondary indices entirely.  Otherwise the previous value is
+      // unpacked once and each secondary key is compared byte-wise against its old key; only keys that actually
+      // changed cost any host calls.
       void put(const void* value, void* old_value,
                std::size_t (*get_size)(const void*),
                void (*deserialize)(void*, const void*, std::size_t),
@@ -162,16 +235,24 @@ namespace internal {
                eosio::name payer) {
          uint32_t value_size;
 
-         auto primary_key = primary_index->get_key_void(value);
-         auto tbl_key = make_prefix(table_name, primary_index->index_name) + primary_key;
+         auto tbl_key = primary_index->get_table_key_void(value);
+
+         size_t data_size = get_size(value);
+         void* data_buffer = data_size > detail::max_stack_buffer_size ? malloc(data_size) : alloca(data_size);
+
+         serialize(value, data_buffer, data_size);
 
          auto primary_key_found = internal_use_do_not_use::kv_get(contract_name.value, tbl_key.data(), tbl_key.size(), value_size);
+         bool unchanged = false;
 
          if (primary_key_found) {
             void* buffer = value_size > detail::max_stack_buffer_size ? malloc(value_size) : alloca(value_size);
             auto copy_size = internal_use_do_not_use::kv_get_data(0, (char*)buffer, value_size);
 
-            deserialize(old_value, buffer, copy_size);
+            unchanged = copy_size == data_size && memcmp(buffer, data_buffer, data_size) == 0;
+            if (!unchanged) {
+               deserialize(old_value, buffer, copy_size);
+            }
 
             if (value_size > detail::max_stack_buffer_size) {
                free(buffer);
@@ -179,36 +260,41 @@ namespace internal {
          }
 
          for (const auto& idx : secondary_indices) {
+            if (unchanged) {
+               break;
+            }
+
             uint32_t value_size;
-            auto sec_tbl_key = make_prefix(table_name, idx->index_name) + idx->get_key_void(value);
-            auto sec_found = internal_use_do_not_use::kv_get(contract_name.value, sec_tbl_key.data(), sec_tbl_key.size(), value_size);
+            auto sec_tbl_key = idx->get_table_key_void(value);
 
             if (!primary_key_found) {
+               auto sec_found = internal_use_do_not_use::kv_get(contract_name.value, sec_tbl_key.data(), sec_tbl_key.size(), value_size);
                eosio::check(!sec_found, "Attempted to store an existing secondary index.");
                internal_use_do_not_use::kv_set(contract_name.value, sec_tbl_key.data(), sec_tbl_key.size(), tbl_key.data(), tbl_key.size(), payer.value);
-            } else {
-               if (sec_found) {
-                  void* buffer = value_size > detail::max_stack_buffer_size ? malloc(value_size) : alloca(value_size);
-                  auto copy_size = internal_use_do_not_use::kv_get_data(0, (char*)buffer, value_size);
-
-                  auto res = memcmp(buffer, tbl_key.data(), copy_size);
-                  eosio::check(copy_size == tbl_key.size() && res == 0, "Attempted to update an existing secondary index.");
-
-                  if (copy_size > detail::max_stack_buffer_size) {
-                     free(buffer);
-                  }
-               } else {
-                  auto old_sec_key = make_prefix(table_name, idx->index_name) + idx->get_key_void(old_value);
-                  internal_use_do_not_use::kv_erase(contract_name.value, old_sec_key.data(), old_sec_key.size());
-                  internal_use_do_not_use::kv_set(contract_name.value, sec_tbl_key.data(), sec_tbl_key.size(), tbl_key.data(), tbl_key.size(), payer.value);
-               }
+               continue;
             }
-         }
 
-         size_t data_size = get_size(value);
-         void* data_buffer = data_size > detail::max_stack_buffer_size ? malloc(data_size) : alloca(data_size);
+            auto old_sec_key = idx->get_table_key_void(old_value);
+            if (old_sec_key.size() == sec_tbl_key.size() && memcmp(old_sec_key.data(), sec_tbl_key.data(), sec_tbl_key.size()) == 0) {
+               continue;
+            }
 
-         serialize(value, data_buffer, data_size);
+            auto sec_found = internal_use_do_not_use::kv_get(contract_name.value, sec_tbl_key.data(), sec_tbl_key.size(), value_size);
+            if (sec_found) {
+               void* buffer = value_size > detail::max_stack_buffer_size ? malloc(value_size) : alloca(value_size);
+               auto copy_size = internal_use_do_not_use::kv_get_data(0, (char*)buffer, value_size);
+
+               auto res = memcmp(buffer, tbl_key.data(), copy_size);
+               eosio::check(copy_size == tbl_key.size() && res == 0, "Attempted to update an existing secondary index.");
+
+               if (value_size > detail::max_stack_buffer_size) {
+                  free(buffer);
+               }
+            } else {
+               internal_use_do_not_use::kv_erase(contract_name.value, old_sec_key.data(), old_sec_key.size());
+               internal_use_do_not_use::kv_set(contract_name.value, sec_tbl_key.data(), sec_tbl_key.size(), tbl_key.data(), tbl_key.size(), payer.value);
+            }
+         }
 
          internal_use_do_not_use::kv_set(contract_name.value, tbl_key.data(), tbl_key.size(), (const char*)data_buffer, data_size, payer.value);
 
@@ -220,8 +306,7 @@ namespace internal {
       void erase(const void* value) {
          uint32_t value_size;
 
-         auto primary_key = primary_index->get_key_void(value);
-         auto tbl_key = make_prefix(table_name, primary_index->index_name) + primary_key;
+         auto tbl_key = primary_index->get_table_key_void(value);
          auto primary_key_found = internal_use_do_not_use::kv_get(contract_name.value, tbl_key.data(), tbl_key.size(), value_size);
 
          if (!primary_key_found) {
@@ -229,7 +314,7 @@ namespace internal {
          }
 
          for (const auto& idx : secondary_indices) {
-            auto sec_tbl_key = make_prefix(table_name, idx->index_name) + idx->get_key_void(value);
+            auto sec_tbl_key = idx->get_table_key_void(value);
             internal_use_do_not_use::kv_erase(contract_name.value, sec_tbl_key.data(), sec_tbl_key.size());
          }
 
@@ -237,11 +322,11 @@ namespace internal {
       }
    };
 
-   inline void index_base::get(const key_type& key, void* ret_val, void (*deserialize)(void*, const void*, std::size_t)) const {
+   inline void index_base::get(const char* key, uint32_t key_size, void* ret_val, void (*deserialize)(void*, const void*, std::size_t)) const {
       uint32_t value_size;
       uint32_t actual_data_size;
 
-      auto success = internal_use_do_not_use::kv_get(contract_name.value, key.data(), key.size(), value_size);
+      auto success = internal_use_do_not_use::kv_get(contract_name.value, key, key_size, value_size);
       if (!success) {
          return;
       }
@@ -289,7 +374,8 @@ namespace internal {
 
       iterator_base(iterator_base&& other) :
          itr(std::exchange(other.itr, 0)),
-         itr_stat(std::move(other.itr_stat))
+         itr_stat(std::move(other.itr_stat)),
+         index(other.index)
       {}
 
       ~iterator_base() {
@@ -359,6 +445,40 @@ namespace internal {
          }
       }
 
+      /**
+       * Reads the serialized row the iterator points to into `scratch`, growing it only when the row does not fit,
+       * and returns the row's size.  Used to stream many rows through one buffer.
+       */
+      uint32_t read_value(std::vector<char>& scratch) const {
+         eosio::check(itr_stat != status::iterator_end, "Cannot read end iterator");
+
+         uint32_t value_size;
+         auto stat = internal_use_do_not_use::kv_it_value(itr, 0, scratch.data(), scratch.size(), value_size);
+         eosio::check(static_cast<status>(stat) == status::iterator_ok, "Error reading value");
+
+         if (value_size > scratch.size()) {
+            scratch.resize(value_size);
+            internal_use_do_not_use::kv_it_value(itr, 0, scratch.data(), value_size, value_size);
+         }
+
+         if (index->index_name != index->tbl->primary_index_name) {
+            uint32_t data_size;
+            auto success = internal_use_do_not_use::kv_get(index->contract_name.value, scratch.data(), value_size, data_size);
+            eosio::check(success, "failure getting primary key in `value()`");
+
+            if (data_size > scratch.size()) {
+               scratch.resize(data_size);
+            }
+            value_size = internal_use_do_not_use::kv_get_data(0, scratch.data(), data_size);
+         }
+
+         return value_size;
+      }
+
+      int32_t key_compare(const key_type& k) const {
+         return internal_use_do_not_use::kv_it_key_compare(itr, k.data(), k.size());
+      }
+
       key_type key() const {
          uint32_t actual_value_size;
          uint32_t value_size;
@@ -594,6 +714,88 @@ public:
    using iterator = table::iterator;
    using value_type = T;
 
+   /**
+    * @ingroup keyvaluetable
+    *
+    * @brief A lazily evaluated, single pass view over the rows of an index within a key range.
+    * @details Rows are read and deserialized one at a time as the view is iterated, through one scratch buffer and
+    * one value slot reused for every row, so stopping early never pays for rows past that point.  At most `limit`
+    * rows are produced.  The referenced row is overwritten when the view advances.
+    */
+   class range_view {
+   public:
+      class iterator {
+      public:
+         using iterator_category = std::input_iterator_tag;
+         using value_type        = T;
+         using difference_type   = std::ptrdiff_t;
+         using pointer           = const T*;
+         using reference         = const T&;
+
+         iterator() = default;
+         explicit iterator(range_view* view) : view(view) {}
+
+         const T& operator*() const { return view->current(); }
+         const T* operator->() const { return &view->current(); }
+
+         iterator& operator++() {
+            view->advance();
+            return *this;
+         }
+
+         bool operator==(const iterator& b) const { return at_end() == b.at_end(); }
+         bool operator!=(const iterator& b) const { return at_end() != b.at_end(); }
+
+      private:
+         bool at_end() const { return view == nullptr || view->done; }
+
+         range_view* view = nullptr;
+      };
+
+      range_view(table::iterator&& cursor, key_type end_key, size_t limit)
+         : cursor(std::move(cursor)), end_key(std::move(end_key)), remaining(limit) {
+         check_done();
+      }
+
+      range_view(range_view&&) = default;
+
+      iterator begin() { return iterator{this}; }
+      iterator end() { return iterator{}; }
+
+      bool empty() const { return done; }
+
+   private:
+      const T& current() {
+         eosio::check(!done, "Cannot read past the end of a range");
+         if (!loaded) {
+            auto size = cursor.read_value(scratch);
+            detail::deserialize(row, scratch.data(), size);
+            loaded = true;
+         }
+         return row;
+      }
+
+      void advance() {
+         eosio::check(!done, "cannot increment end iterator");
+         ++cursor;
+         --remaining;
+         loaded = false;
+         check_done();
+      }
+
+      void check_done() {
+         done = remaining == 0 || !cursor.valid() || cursor.key_compare(end_key) >= 0;
+      }
+
+      table::iterator   cursor;
+      key_type          end_key;
+      size_t            remaining;
+      std::vector<char> scratch = std::vector<char>(detail::max_stack_buffer_size);
+      T                 row;
+      bool              loaded = false;
+      bool              done   = false;
+   };
+
    /**
     * @ingroup keyvaluetable
     *
@@ -629,7 +831,7 @@ public:
        * @return An iterator to the found object OR the `end` iterator if the given key was not found.
        */
       iterator find(const K& key) const {
-         auto t_key = prefix + make_key(key);
+         auto t_key = detail::make_table_key(prefix, key);
 
          uint32_t itr = internal_use_do_not_use::kv_it_create(contract_name.value, prefix.data(), prefix.size());
          int32_t itr_stat = detail::itr_lower_bound(itr, {t_key.data(), t_key.size()});
@@ -653,7 +855,7 @@ public:
        */
       bool exists(const K& key) const {
          uint32_t value_size;
-         auto t_key = prefix + make_key(key);
+         auto t_key = detail::make_table_key(prefix, key);
 
          return internal_use_do_not_use::kv_get(contract_name.value, t_key.data(), t_key.size(), value_size);
       }
@@ -680,8 +882,8 @@ public:
        */
       std::optional<T> get(const K& key) const {
          std::optional<T> ret_val;
-         auto k = prefix + make_key(key);
-         index_base::get(k, &ret_val, &deserialize_optional_fun);
+         auto k = detail::make_table_key(prefix, key);
+         index_base::get(k.data(), k.size(), &ret_val, &deserialize_optional_fun);
          return ret_val;
       }
 
@@ -738,7 +940,7 @@ public:
        * @return An iterator pointing to the element with the lowest key greater than or equal to the given key.
        */
       iterator lower_bound(const K& key) const {
-         auto t_key = prefix + make_key(key);
+         auto t_key = detail::make_table_key(prefix, key);
 
          uint32_t itr = internal_use_do_not_use::kv_it_create(contract_name.value, prefix.data(), prefix.size());
          int32_t itr_stat = detail::itr_lower_bound(itr, {t_key.data(), t_key.size()});
@@ -753,7 +955,7 @@ public:
        * @return An iterator pointing to the first element greater than the given key.
        */
       iterator upper_bound(const K& key) const {
-         auto t_key = prefix + make_key(key);
+         auto t_key = detail::make_table_key(prefix, key);
          auto it = lower_bound(key);
 
          int32_t cmp;
@@ -781,13 +983,28 @@ public:
       std::vector<T> range(const K& b, const K& e) const {
          std::vector<T> return_values;
 
-         for(auto itr = lower_bound(b), end_itr = lower_bound(e); itr < end_itr; ++itr) {
-            return_values.push_back(itr.value());
+         for (const auto& value : view(b, e)) {
+            return_values.push_back(value);
          }
 
          return return_values;
       }
 
+      /**
+       * Returns a lazy view of the objects that fall between the specified range, without materializing them.
+       * The range is inclusive, exclusive.
+       * @ingroup keyvaluetable
+       *
+       * @param begin - The beginning of the range (inclusive).
+       * @param end - The end of the range (exclusive).
+       * @param limit - The maximum number of objects the view will produce.
+       * @return A view that reads and deserializes each object as it is reached.
+       */
+      range_view view(const K& b, const K& e, size_t limit = std::numeric_limits<size_t>::max()) const {
+         auto end_key = detail::make_table_key(prefix, e);
+         return range_view{lower_bound(b), key_type{end_key.data(), end_key.size()}, limit};
+      }
+
       void setup() override {
          prefix = make_prefix(table_name, index_name);
       }
@@ -803,8 +1020,15 @@ public:
     * @param payer - The payer for the entry.
     */
    void put(const T& value, eosio::name payer) {
-      T old_value;
-      table_base::put(&value, &old_value, &get_size_fun, &deserialize_fun, &serialize_fun, payer);
+      // The indices are only registered when the constructor calls init(), so this is a runtime check: both paths
+      // are compiled into every table, and with secondary indices the old row is still unpacked whenever its
+      // stored bytes differ from the new value.
+      if (secondary_indices.empty()) {
+         table_base::put_primary(&value, &get_size_fun, &serialize_fun, payer);
+      } else {
+         T old_value;
+         table_base::put(&value, &old_value, &get_size_fun, &deserialize_fun, &serialize_fun, payer);
+      }
    }
 
    /* @cond PRIVATE */
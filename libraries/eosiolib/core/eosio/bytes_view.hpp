@@ -0,0 +1,95 @@
+/**
+ *  @file
+ *  @copyright defined in eos/LICENSE
+ */
+#pragma once
+
+#include "datastream.hpp"
+
+#include <string_view>
+
+namespace eosio {
+   /**
+    * @defgroup bytes_view
+    * @ingroup core
+    * @brief A non-owning view of a run of bytes with the serialized form (and ABI type) of `bytes`.
+    */
+
+   /**
+    * A non-owning view of a run of bytes.
+    *
+    * @ingroup bytes_view
+    * @details Serializes exactly like `std::vector<char>`, but deserializing one points it into the stream's buffer
+    * instead of copying.  Declaring an action parameter as `bytes_view` lets the dispatcher hand the action a view
+    * straight into the action data; the view is only valid for the duration of the action.
+    */
+   class bytes_view {
+   public:
+      constexpr bytes_view() = default;
+      constexpr bytes_view(const char* data, size_t size) : _data(data), _size(size) {}
+      bytes_view(const std::vector<char>& v) : _data(v.data()), _size(v.size()) {}
+      constexpr explicit bytes_view(std::string_view sv) : _data(sv.data()), _size(sv.size()) {}
+
+      constexpr const char* data() const { return _data; }
+      constexpr size_t size() const { return _size; }
+      constexpr bool empty() const { return _size == 0; }
+
+      constexpr const char* begin() const { return _data; }
+      constexpr const char* end() const { return _data + _size; }
+
+      constexpr char operator[](size_t i) const { return _data[i]; }
+
+      /**
+       * Copies the viewed bytes into an owning vector
+       */
+      std::vector<char> to_vector() const { return std::vector<char>(begin(), end()); }
+
+      friend bool operator==(const bytes_view& a, const bytes_view& b) {
+         return std::string_view(a._data, a._size) == std::string_view(b._data, b._size);
+      }
+      friend bool operator!=(const bytes_view& a, const bytes_view& b) {
+         return !(a == b);
+      }
+
+   private:
+      const char* _data = nullptr;
+      size_t      _size = 0;
+   };
+
+   /**
+    *  Serialize a bytes_view into a stream
+    *
+    *  @ingroup bytes_view
+    *  @param ds - The stream to write
+    *  @param v - The value to serialize
+    *  @tparam Stream - Type of datastream buffer
+    *  @return datastream<Stream>& - Reference to the datastream
+    */
+   template<typename Stream>
+   datastream<Stream>& operator<<(datastream<Stream>& ds, const bytes_view& v) {
+      ds << unsigned_int( v.size() );
+      if (v.size())
+         ds.write(v.data(), v.size());
+      return ds;
+   }
+
+   /**
+    *  Deserialize a bytes_view from a stream without copying it
+    *
+    *  @ingroup bytes_view
+    *  @details The view points into the stream's buffer, so the buffer must outlive it.
+    *  @param ds - The stream to read
+    *  @param v - The destination for deserialized value
+    *  @tparam Stream - Type of datastream buffer
+    *  @return datastream<Stream>& - Reference to the datastream
+    */
+   template<typename Stream>
+   datastream<Stream>& operator>>(datastream<Stream>& ds, bytes_view& v) {
+      unsigned_int s;
+      ds >> s;
+      eosio::check( ds.remaining() >= s.value, "datastream attempted to read past the end" );
+      v = bytes_view( ds.pos(), s.value );
+      ds.skip( s.value );
+      return ds;
+   }
+} // namespace eosio
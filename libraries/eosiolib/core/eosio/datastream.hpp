@@ -13,6 +13,7 @@
 #include <set>
 #include <map>
 #include <string>
+#include <string_view>
 #include <optional>
 #include <variant>
 
@@ -521,18 +522,79 @@ datastream<Stream>& operator << ( datastream<Stream>& ds, const std::string& v )
  */
 template<typename Stream>
 datastream<Stream>& operator >> ( datastream<Stream>& ds, std::string& v ) {
-   std::vector<char> tmp;
-   ds >> tmp;
-   if( tmp.size() )
-      v = std::string(tmp.data(),tmp.data()+tmp.size());
-   else
-      v = std::string();
+   unsigned_int s;
+   ds >> s;
+   v.resize( s.value );
+   if( s.value )
+      ds.read( v.data(), v.size() );
+   return ds;
+}
+
+/**
+ *  Serialize a string_view into a stream, in the same format as a string
+ *
+ *  @param ds - The stream to write
+ *  @param v - The value to serialize
+ *  @tparam Stream - Type of datastream buffer
+ *  @return datastream<Stream>& - Reference to the datastream
+ */
+template<typename Stream, typename T, std::enable_if_t<std::is_same_v<T, std::string_view>>* = nullptr>
+datastream<Stream>& operator << ( datastream<Stream>& ds, const T& v ) {
+   ds << unsigned_int( v.size() );
+   if (v.size())
+      ds.write(v.data(), v.size());
+   return ds;
+}
+
+/**
+ *  Deserialize a string_view from a stream without copying it
+ *
+ *  @details The view points into the stream's buffer, so the buffer must outlive it.
+ *  @param ds - The stream to read
+ *  @param v - The destination for deserialized value
+ *  @tparam Stream - Type of datastream buffer
+ *  @return datastream<Stream>& - Reference to the datastream
+ */
+template<typename Stream>
+datastream<Stream>& operator >> ( datastream<Stream>& ds, std::string_view& v ) {
+   unsigned_int s;
+   ds >> s;
+   eosio::check( ds.remaining() >= s.value, "datastream attempted to read past the end" );
+   v = std::string_view( ds.pos(), s.value );
+   ds.skip( s.value );
    return ds;
 }
 
+/**
+ *  Trait for types whose packed form is exactly their in-memory bytes, so that they can be written and read with a
+ *  single bounds check and one memcpy, and whose `pack_size` is `sizeof(T)` at compile time.
+ *
+ *  @details Holds for arithmetic types other than bool, enums, `std::array`s of such types and classes using
+ *  `EOSLIB_SERIALIZE` whose listed members are themselves bitwise serializable, appear in declaration order and
+ *  cover the whole object without padding.  Types with a hand written serializer that matches their layout can opt
+ *  in by specializing this trait.
+ *
+ *  @ingroup datastream
+ *  @tparam T - The type to be checked
+ */
+template<typename T, typename = void>
+struct is_bitwise_serializable : std::false_type {};
+
+template<typename T>
+struct is_bitwise_serializable<T, std::enable_if_t<(std::is_arithmetic_v<T> && !std::is_same_v<T, bool>) ||
+                                                   std::is_enum_v<T>>> : std::true_type {};
+
+template<typename T, std::size_t N>
+struct is_bitwise_serializable<std::array<T, N>> : is_bitwise_serializable<T> {};
+
+template<typename T>
+struct is_bitwise_serializable<T, std::enable_if_t<T::template eosio_bitwise_layout<T>()>> : std::true_type {};
+
 /**
  *  Serialize a fixed size std::array
  *
+ *  @details Arrays of bitwise serializable elements are written with a single copy
+ *
  *  @param ds - The stream to write
  *  @param v - The value to serialize
  *  @tparam Stream - Type of datastream buffer
@@ -542,8 +604,12 @@ datastream<Stream>& operator >> ( datastream<Stream>& ds, std::string& v ) {
  */
 template<typename Stream, typename T, std::size_t N>
 datastream<Stream>& operator << ( datastream<Stream>& ds, const std::array<T,N>& v ) {
-   for( const auto& i : v )
-      ds << i;
+   if constexpr( is_bitwise_serializable<T>::value ) {
+      ds.write( (const char*)v.data(), sizeof(v) );
+   } else {
+      for( const auto& i : v )
+         ds << i;
+   }
    return ds;
 }
 
@@ -551,6 +617,8 @@ datastream<Stream>& operator << ( datastream<Stream>& ds, const std::array<T,N>&
 /**
  *  Deserialize a fixed size std::array
  *
+ *  @details Arrays of bitwise serializable elements are read with a single copy
+ *
  *  @param ds - The stream to read
  *  @param v - The destination for deserialized value
  *  @tparam Stream - Type of datastream buffer
@@ -560,8 +628,12 @@ datastream<Stream>& operator << ( datastream<Stream>& ds, const std::array<T,N>&
  */
 template<typename Stream, typename T, std::size_t N>
 datastream<Stream>& operator >> ( datastream<Stream>& ds, std::array<T,N>& v ) {
-   for( auto& i : v )
-      ds >> i;
+   if constexpr( is_bitwise_serializable<T>::value ) {
+      ds.read( (char*)v.data(), sizeof(v) );
+   } else {
+      for( auto& i : v )
+         ds >> i;
+   }
    return ds;
 }
 
@@ -602,6 +674,33 @@ namespace _datastream_detail {
    struct is_datastream { static constexpr bool value = false; };
    template<typename T>
    struct is_datastream<datastream<T>> { static constexpr bool value = true; };
+
+   /*
+    * Whether T is bitwise serializable, deferred until the stream type is known so that it can be used from the
+    * serializers that EOSLIB_SERIALIZE defines inside the class being checked
+    */
+   template<typename DataStream, typename T>
+   constexpr bool is_bitwise_for = is_bitwise_serializable<T>::value;
+
+   template<typename T, std::size_t... I>
+   constexpr bool fields_are_bitwise( std::index_sequence<I...> ) {
+      return ( is_bitwise_serializable<std::remove_cv_t<boost::pfr::tuple_element_t<I, T>>>::value && ... ) &&
+             ( sizeof(boost::pfr::tuple_element_t<I, T>) + ... + 0 ) == sizeof(T);
+   }
+
+   /*
+    * Check if the aggregate T, serialized field by field through boost::pfr, has a packed form identical to its
+    * in-memory bytes: every field is bitwise serializable and the fields leave no padding between or after them
+    *
+    * @tparam T - The type to be checked
+    */
+   template<typename T>
+   constexpr bool is_bitwise_aggregate() {
+      if constexpr( std::is_aggregate_v<T> && std::is_trivially_copyable_v<T> && std::is_standard_layout_v<T> )
+         return fields_are_bitwise<T>( std::make_index_sequence<boost::pfr::tuple_size_v<T>>{} );
+      else
+         return false;
+   }
 }
 
 /**
@@ -716,6 +815,7 @@ datastream<Stream>& operator << ( datastream<Stream>& ds, const std::vector<char
 /**
  *  Serialize a vector
  *
+ *  @details Elements that are bitwise serializable are written with a single copy
  *  @param ds - The stream to write
  *  @param v - The value to serialize
  *  @tparam Stream - Type of datastream buffer
@@ -725,8 +825,12 @@ datastream<Stream>& operator << ( datastream<Stream>& ds, const std::vector<char
 template<typename Stream, typename T>
 datastream<Stream>& operator << ( datastream<Stream>& ds, const std::vector<T>& v ) {
    ds << unsigned_int( v.size() );
-   for( const auto& i : v )
-      ds << i;
+   if constexpr( is_bitwise_serializable<T>::value ) {
+      ds.write( (const char*)v.data(), v.size() * sizeof(T) );
+   } else {
+      for( const auto& i : v )
+         ds << i;
+   }
    return ds;
 }
 
@@ -750,6 +854,7 @@ datastream<Stream>& operator >> ( datastream<Stream>& ds, std::vector<char>& v )
 /**
  *  Deserialize a vector
  *
+ *  @details Elements that are bitwise serializable are read with a single copy
  *  @param ds - The stream to read
  *  @param v - The destination for deserialized value
  *  @tparam Stream - Type of datastream buffer
@@ -761,8 +866,12 @@ datastream<Stream>& operator >> ( datastream<Stream>& ds, std::vector<T>& v ) {
    unsigned_int s;
    ds >> s;
    v.resize(s.value);
-   for( auto& i : v )
-      ds >> i;
+   if constexpr( is_bitwise_serializable<T>::value ) {
+      ds.read( (char*)v.data(), v.size() * sizeof(T) );
+   } else {
+      for( auto& i : v )
+         ds >> i;
+   }
    return ds;
 }
 
@@ -886,6 +995,7 @@ datastream<Stream>& operator>>( datastream<Stream>& ds, std::tuple<Args...>& t )
 /**
  *  Serialize a class
  *
+ *  @details Aggregates whose fields are all bitwise serializable and leave no padding are written with a single copy
  *  @param ds - The stream to write
  *  @param v - The value to serialize
  *  @tparam DataStream - Type of datastream
@@ -894,15 +1004,20 @@ datastream<Stream>& operator>>( datastream<Stream>& ds, std::tuple<Args...>& t )
  */
 template<typename DataStream, typename T, std::enable_if_t<std::is_class<T>::value && _datastream_detail::is_datastream<DataStream>::value>* = nullptr>
 DataStream& operator<<( DataStream& ds, const T& v ) {
-   boost::pfr::for_each_field(v, [&](const auto& field) {
-      ds << field;
-   });
+   if constexpr( is_bitwise_serializable<T>::value || _datastream_detail::is_bitwise_aggregate<T>() ) {
+      ds.write( (const char*)&v, sizeof(T) );
+   } else {
+      boost::pfr::for_each_field(v, [&](const auto& field) {
+         ds << field;
+      });
+   }
    return ds;
 }
 
 /**
  *  Deserialize a class
  *
+ *  @details Aggregates whose fields are all bitwise serializable and leave no padding are read with a single copy
  *  @param ds - The stream to read
  *  @param v - The destination for deserialized value
  *  @tparam DataStream - Type of datastream
@@ -911,9 +1026,13 @@ DataStream& operator<<( DataStream& ds, const T& v ) {
  */
 template<typename DataStream, typename T, std::enable_if_t<std::is_class<T>::value && _datastream_detail::is_datastream<DataStream>::value>* = nullptr>
 DataStream& operator>>( DataStream& ds, T& v ) {
-   boost::pfr::for_each_field(v, [&](auto& field) {
-      ds >> field;
-   });
+   if constexpr( is_bitwise_serializable<T>::value || _datastream_detail::is_bitwise_aggregate<T>() ) {
+      ds.read( (char*)&v, sizeof(T) );
+   } else {
+      boost::pfr::for_each_field(v, [&](auto& field) {
+         ds >> field;
+      });
+   }
    return ds;
 }
 
@@ -996,16 +1115,21 @@ T unpack( const std::vector<char>& bytes ) {
 /**
  * Get the size of the packed data
  *
+ * @details For bitwise serializable types this is `sizeof(T)` and can be used in constant expressions
  * @ingroup datastream
  * @tparam T - Type of the data to be packed
  * @param value - Data to be packed
  * @return size_t - Size of the packed data
  */
 template<typename T>
-size_t pack_size( const T& value ) {
-  datastream<size_t> ps;
-  ps << value;
-  return ps.tellp();
+constexpr size_t pack_size( const T& value ) {
+  if constexpr( is_bitwise_serializable<T>::value ) {
+    return sizeof(T);
+  } else {
+    datastream<size_t> ps;
+    ps << value;
+    return ps.tellp();
+  }
 }
 
 /**
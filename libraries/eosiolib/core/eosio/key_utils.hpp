@@ -340,4 +340,62 @@ key_type convert_to_key(const T& t) {
    convert_to_key(t, result);
    return result;
 }
+
+namespace detail {
+   template <typename T>
+   struct is_std_tuple : std::false_type {};
+   template <typename... Ts>
+   struct is_std_tuple<std::tuple<Ts...>> : std::true_type {};
+   template <typename T, typename U>
+   struct is_std_tuple<std::pair<T, U>> : std::true_type {};
+
+   template <typename T>
+   struct is_std_array : std::false_type {};
+   template <typename T, std::size_t N>
+   struct is_std_array<std::array<T, N>> : std::true_type {};
+
+   template <typename T>
+   constexpr std::size_t max_key_size();
+
+   template <typename Tuple, std::size_t... Is>
+   constexpr std::size_t max_key_size_of_fields(std::index_sequence<Is...>) {
+      constexpr std::size_t sizes[] = { 0, max_key_size<std::decay_t<std::tuple_element_t<Is, Tuple>>>()... };
+      std::size_t total = 0;
+      for (std::size_t i = 1; i < sizeof(sizes)/sizeof(sizes[0]); ++i) {
+         if (sizes[i] == 0)
+            return 0;
+         total += sizes[i];
+      }
+      return total;
+   }
+
+   template <typename T>
+   constexpr std::size_t max_key_size() {
+      if constexpr (std::is_arithmetic_v<T> || std::is_enum_v<T>) {
+         return sizeof(T);
+      } else if constexpr (is_std_tuple<T>::value) {
+         return max_key_size_of_fields<T>(std::make_index_sequence<std::tuple_size_v<T>>{});
+      } else if constexpr (is_std_array<T>::value) {
+         return std::tuple_size_v<T> * max_key_size<typename T::value_type>();
+      } else if constexpr (std::is_class_v<T>) {
+         if constexpr (BLUEGRASS_HAS_MEMBER_TY(T, _bluegrass_meta_refl_valid)) {
+            using fields = typename bluegrass::meta::meta_object<T>::field_types;
+            return max_key_size_of_fields<fields>(std::make_index_sequence<std::tuple_size_v<fields>>{});
+         } else {
+            return 0;
+         }
+      } else {
+         return 0;
+      }
+   }
+} // namespace eosio::detail
+
+/**
+ * The largest number of bytes `to_key` can produce for a value of type T, or 0 when the encoding has no fixed
+ * bound (strings, containers, optionals, variants, or anything containing one of those).
+ */
+template <typename T>
+constexpr std::size_t max_key_size() {
+   return detail::max_key_size<std::decay_t<T>>();
+}
 } // namespace eosio
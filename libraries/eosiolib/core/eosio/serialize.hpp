@@ -4,9 +4,19 @@
 #include <boost/preprocessor/seq/seq.hpp>
 #include <boost/preprocessor/stringize.hpp>
 
+#include <cstddef>
+#include <type_traits>
+
+#include "datastream.hpp"
+
 #define EOSLIB_REFLECT_MEMBER_OP( r, OP, elem ) \
   OP t.elem
 
+#define EOSLIB_LAYOUT_MEMBER_OP( r, SELF, elem ) \
+  packed = packed && offsetof( SELF, elem ) == offset && \
+           eosio::is_bitwise_serializable<std::remove_cv_t<decltype(SELF::elem)>>::value; \
+  offset += sizeof(SELF::elem);
+
 /**
  *  @defgroup serialize Serialize
  *  @ingroup core
@@ -16,18 +26,42 @@
 /**
  *  Defines serialization and deserialization for a class
  *
+ *  @details When every listed member is bitwise serializable and the members, in the order listed, make up the whole
+ *  object without padding, the class is itself bitwise serializable and is written and read with a single copy.
  *  @ingroup serialize
  *  @param TYPE - the class to have its serialization and deserialization defined
  *  @param MEMBERS - a sequence of member names.  (field1)(field2)(field3)
  */
 #define EOSLIB_SERIALIZE( TYPE,  MEMBERS ) \
+ template<typename, typename> friend struct eosio::is_bitwise_serializable; \
+ template<typename Self> \
+ static constexpr bool eosio_bitwise_layout() { \
+    if constexpr( std::is_same_v<Self, TYPE> && std::is_trivially_copyable_v<Self> && std::is_standard_layout_v<Self> ) { \
+       bool packed = true; \
+       std::size_t offset = 0; \
+       BOOST_PP_SEQ_FOR_EACH( EOSLIB_LAYOUT_MEMBER_OP, Self, MEMBERS ) \
+       return packed && offset == sizeof(Self); \
+    } else { \
+       return false; \
+    } \
+ }\
  template<typename DataStream> \
  friend DataStream& operator << ( DataStream& ds, const TYPE& t ){ \
-    return ds BOOST_PP_SEQ_FOR_EACH( EOSLIB_REFLECT_MEMBER_OP, <<, MEMBERS );\
+    if constexpr( eosio::_datastream_detail::is_bitwise_for<DataStream, TYPE> ) { \
+       ds.write( (const char*)&t, sizeof(TYPE) ); \
+       return ds; \
+    } else { \
+       return ds BOOST_PP_SEQ_FOR_EACH( EOSLIB_REFLECT_MEMBER_OP, <<, MEMBERS );\
+    } \
  }\
  template<typename DataStream> \
  friend DataStream& operator >> ( DataStream& ds, TYPE& t ){ \
-    return ds BOOST_PP_SEQ_FOR_EACH( EOSLIB_REFLECT_MEMBER_OP, >>, MEMBERS );\
+    if constexpr( eosio::_datastream_detail::is_bitwise_for<DataStream, TYPE> ) { \
+       ds.read( (char*)&t, sizeof(TYPE) ); \
+       return ds; \
+    } else { \
+       return ds BOOST_PP_SEQ_FOR_EACH( EOSLIB_REFLECT_MEMBER_OP, >>, MEMBERS );\
+    } \
  }
 
 /**
@@ -373,6 +373,16 @@ namespace eosio {
      return ds;
    }
 
+   /// @cond IMPLEMENTATIONS
+
+   // both are packed as their raw uint64_t value, which is also all they hold
+   template<>
+   struct is_bitwise_serializable<symbol_code> : std::bool_constant<sizeof(symbol_code) == sizeof(uint64_t)> {};
+   template<>
+   struct is_bitwise_serializable<symbol> : std::bool_constant<sizeof(symbol) == sizeof(uint64_t)> {};
+
+   /// @endcond
+
    /**
     *  Extended asset which stores the information of the owner of the symbol
     *
@@ -2,57 +2,9 @@
 #include <alloca.h>
 #include "core/eosio/check.hpp"
 #include "core/eosio/print.hpp"
-
-#ifdef EOSIO_NATIVE
-   extern "C" {
-      size_t _current_memory();
-      size_t _grow_memory(size_t);
-   }
-#define CURRENT_MEMORY _current_memory()
-#define GROW_MEMORY(X) _grow_memory(X)
-#else
-#define CURRENT_MEMORY __builtin_wasm_memory_size(0)
-#define GROW_MEMORY(X) __builtin_wasm_memory_grow(0, X)
-#endif
+#include "sbrk.hpp"
 
 namespace eosio {
-   extern "C" uintptr_t  __get_heap_base();
-   void* sbrk(size_t num_bytes) {
-         constexpr size_t NBPPL2  = 16U;
-         constexpr size_t NBBP    = 65536U;
-
-         static bool initialized;
-         static size_t sbrk_bytes;
-         if(!initialized) {
-            sbrk_bytes = CURRENT_MEMORY * NBBP;
-            initialized = true;
-         }
-
-         if(num_bytes > INT32_MAX)
-            return reinterpret_cast<void*>(-1);
-
-         const size_t prev_num_bytes = sbrk_bytes;
-         const size_t current_pages = CURRENT_MEMORY;
-
-         // round the absolute value of num_bytes to an alignment boundary
-         num_bytes = (num_bytes + 7U) & ~7U;
-
-         // update the number of bytes allocated, and compute the number of pages needed
-         const size_t num_desired_pages = (sbrk_bytes + num_bytes + NBBP - 1) >> NBPPL2;
-
-         if(num_desired_pages > current_pages) {
-            if (GROW_MEMORY(num_desired_pages - current_pages) == -1)
-               return reinterpret_cast<void*>(-1);
-         }
-
-         sbrk_bytes += num_bytes;
-#ifdef EOSIO_NATIVE
-      return reinterpret_cast<void*>((char*)__get_heap_base()+prev_num_bytes);
-#else
-      return reinterpret_cast<void*>(prev_num_bytes);
-#endif
-   }
-
    using ::memset;
    using ::memcpy;
 
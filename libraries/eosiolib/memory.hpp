@@ -0,0 +1,140 @@
+/**
+ *  @file
+ *  @copyright defined in eos/LICENSE
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace eosio { namespace cmem {
+
+   /**
+    * Word-at-a-time implementations of the C memory primitives backing eosio_cmem.
+    *
+    * Destination pointers are aligned to 8 bytes with a byte-wise head, the body is moved in 64 bit words (source
+    * reads may be unaligned, which WebAssembly permits) and the remainder is finished byte-wise.  None of these
+    * allocate.  When the bulk-memory target feature is enabled the copy and fill primitives lower to
+    * `memory.copy`/`memory.fill` instead.
+    */
+   typedef uint64_t __attribute__((__may_alias__, __aligned__(1))) unaligned_word;
+   typedef uint64_t __attribute__((__may_alias__)) aligned_word;
+
+   constexpr size_t word_size = sizeof(uint64_t);
+
+   inline size_t misalignment(const void* ptr) {
+      return reinterpret_cast<uintptr_t>(ptr) & (word_size - 1);
+   }
+
+   inline void* copy(void* dst, const void* src, size_t n) {
+#if defined(__wasm_bulk_memory__)
+      return __builtin_memcpy(dst, src, n);
+#else
+      uint8_t* d = static_cast<uint8_t*>(dst);
+      const uint8_t* s = static_cast<const uint8_t*>(src);
+
+      if (n >= word_size) {
+         while (misalignment(d)) {
+            *d++ = *s++;
+            --n;
+         }
+         for (; n >= 4*word_size; n -= 4*word_size, d += 4*word_size, s += 4*word_size) {
+            const uint64_t w0 = reinterpret_cast<const unaligned_word*>(s)[0];
+            const uint64_t w1 = reinterpret_cast<const unaligned_word*>(s)[1];
+            const uint64_t w2 = reinterpret_cast<const unaligned_word*>(s)[2];
+            const uint64_t w3 = reinterpret_cast<const unaligned_word*>(s)[3];
+            reinterpret_cast<aligned_word*>(d)[0] = w0;
+            reinterpret_cast<aligned_word*>(d)[1] = w1;
+            reinterpret_cast<aligned_word*>(d)[2] = w2;
+            reinterpret_cast<aligned_word*>(d)[3] = w3;
+         }
+         for (; n >= word_size; n -= word_size, d += word_size, s += word_size)
+            *reinterpret_cast<aligned_word*>(d) = *reinterpret_cast<const unaligned_word*>(s);
+      }
+      while (n--)
+         *d++ = *s++;
+      return dst;
+#endif
+   }
+
+   // copies from the highest address downwards, safe when dst overlaps the tail of src
+   inline void* copy_backward(void* dst, const void* src, size_t n) {
+      uint8_t* d = static_cast<uint8_t*>(dst) + n;
+      const uint8_t* s = static_cast<const uint8_t*>(src) + n;
+
+      if (n >= word_size) {
+         while (misalignment(d)) {
+            *--d = *--s;
+            --n;
+         }
+         for (; n >= word_size; n -= word_size) {
+            d -= word_size;
+            s -= word_size;
+            *reinterpret_cast<aligned_word*>(d) = *reinterpret_cast<const unaligned_word*>(s);
+         }
+      }
+      while (n--)
+         *--d = *--s;
+      return dst;
+   }
+
+   inline void* move(void* dst, const void* src, size_t n) {
+#if defined(__wasm_bulk_memory__)
+      return __builtin_memmove(dst, src, n);
+#else
+      const uintptr_t d = reinterpret_cast<uintptr_t>(dst);
+      const uintptr_t s = reinterpret_cast<uintptr_t>(src);
+      if (d == s || n == 0)
+         return dst;
+      // a forward copy only reads ahead of what it has written, so it is safe whenever dst is below src
+      if (d < s || d - s >= n)
+         return copy(dst, src, n);
+      return copy_backward(dst, src, n);
+#endif
+   }
+
+   inline void* fill(void* dst, int c, size_t n) {
+#if defined(__wasm_bulk_memory__)
+      return __builtin_memset(dst, c, n);
+#else
+      uint8_t* d = static_cast<uint8_t*>(dst);
+      const uint8_t b = static_cast<uint8_t>(c);
+
+      if (n >= word_size) {
+         while (misalignment(d)) {
+            *d++ = b;
+            --n;
+         }
+         const uint64_t w = uint64_t(b) * 0x0101010101010101ull;
+         for (; n >= 4*word_size; n -= 4*word_size, d += 4*word_size) {
+            reinterpret_cast<aligned_word*>(d)[0] = w;
+            reinterpret_cast<aligned_word*>(d)[1] = w;
+            reinterpret_cast<aligned_word*>(d)[2] = w;
+            reinterpret_cast<aligned_word*>(d)[3] = w;
+         }
+         for (; n >= word_size; n -= word_size, d += word_size)
+            *reinterpret_cast<aligned_word*>(d) = w;
+      }
+      while (n--)
+         *d++ = b;
+      return dst;
+#endif
+   }
+
+   inline int compare(const void* lhs, const void* rhs, size_t n) {
+      const uint8_t* p1 = static_cast<const uint8_t*>(lhs);
+      const uint8_t* p2 = static_cast<const uint8_t*>(rhs);
+
+      // skip over the common prefix a word at a time, then locate the differing byte
+      for (; n >= word_size; n -= word_size, p1 += word_size, p2 += word_size) {
+         if (*reinterpret_cast<const unaligned_word*>(p1) != *reinterpret_cast<const unaligned_word*>(p2))
+            break;
+      }
+      for (; n > 0; --n, ++p1, ++p2) {
+         if (*p1 != *p2)
+            return *p1 < *p2 ? -1 : 1;
+      }
+      return 0;
+   }
+
+}} // ns eosio::cmem
@@ -0,0 +1,238 @@
+#include <cstdlib>
+#include <cstring>
+#include "core/eosio/check.hpp"
+#include "sbrk.hpp"
+
+namespace eosio {
+   /**
+    * Segregated free-list allocator.
+    *
+    * Small requests are rounded up to a power-of-two block size (16 bytes up to 32KiB, header included) and served
+    * from a per-size-class free list, or carved from the current sbrk'd region when that list is empty.  Requests
+    * that do not fit the largest class are given their own sbrk'd block and recycled through a separate first-fit
+    * list of large blocks.  Every block is preceded by an 8 byte header holding its size class (or its byte size for
+    * large blocks) and a tag, so free never has to search for the owning heap.
+    *
+    * Headers sit at addresses that are 8 mod 16, so every returned pointer is 16 byte aligned.
+    */
+   class size_class_memory_manager  // NOTE: Should never allocate another instance of size_class_memory_manager
+   {
+   friend void* ::malloc(size_t size);
+   friend void* ::calloc(size_t count, size_t size);
+   friend void* ::realloc(void* ptr, size_t size);
+   friend void  ::free(void* ptr);
+
+   // NOTE: like memory_manager, this relies on the zero-initialized state of the global being a valid empty heap,
+   //       so no member may require a constructor to run.
+   private:
+      struct header {
+         uint32_t info;  // size class for small blocks, block size in bytes for large blocks
+         uint32_t tag;
+      };
+
+      struct free_block {
+         free_block* next;
+      };
+
+      static constexpr size_t   _header_size      = sizeof(header);
+      static constexpr size_t   _min_block_log2   = 4;
+      static constexpr size_t   _num_classes      = 12;
+      static constexpr size_t   _max_small_block  = size_t(1) << (_min_block_log2 + _num_classes - 1);
+      static constexpr size_t   _region_size      = 64*1024;
+      static constexpr uint32_t _alloc_tag        = 0xA110CA7E;
+      static constexpr uint32_t _free_tag         = 0xF4EEB10C;
+
+      static_assert(_header_size == 8, "block layout assumes an 8 byte header");
+
+      static size_t block_size(size_t cls) {
+         return size_t(1) << (cls + _min_block_log2);
+      }
+
+      static size_t size_class(size_t size) {
+         const size_t needed = size + _header_size;
+         if (needed <= block_size(0))
+            return 0;
+         // ceil(log2(needed)) - log2(smallest block)
+         return (sizeof(unsigned long long)*8 - __builtin_clzll(needed - 1)) - _min_block_log2;
+      }
+
+      static header* header_of(void* ptr) {
+         return reinterpret_cast<header*>(static_cast<char*>(ptr) - _header_size);
+      }
+
+      static void* payload_of(char* block) {
+         return block + _header_size;
+      }
+
+      static char* align_block(char* ptr) {
+         // move forward to the next address that is 8 mod 16
+         return ptr + ((8 - reinterpret_cast<uintptr_t>(ptr)) & 15);
+      }
+
+      char* grow(size_t size) {
+         char* mem = reinterpret_cast<char*>(sbrk(size));
+         eosio::check(reinterpret_cast<intptr_t>(mem) != -1, "failed to allocate pages");
+         return mem;
+      }
+
+      void push_free(size_t cls, char* block) {
+         header* hdr = reinterpret_cast<header*>(block);
+         hdr->info = cls;
+         hdr->tag  = _free_tag;
+         free_block* fb = static_cast<free_block*>(payload_of(block));
+         fb->next = _bins[cls];
+         _bins[cls] = fb;
+      }
+
+      // hand out whatever is left of the current region to the free lists, largest blocks first
+      void retire_region() {
+         size_t remaining = _limit - _cursor;
+         for (size_t cls = _num_classes; cls-- > 0 && remaining > 0;) {
+            while (remaining >= block_size(cls)) {
+               push_free(cls, _cursor);
+               _cursor   += block_size(cls);
+               remaining -= block_size(cls);
+            }
+         }
+         _cursor = _limit;
+      }
+
+      void refill(size_t needed) {
+         const size_t len = needed > _region_size ? needed : _region_size;
+         char* mem = grow(len + 16);
+         if (_limit != nullptr && mem == _limit + 8) {
+            // contiguous with the current region, just extend it
+            _limit += len + 16;
+            return;
+         }
+         retire_region();
+         _cursor = align_block(mem);
+         _limit  = _cursor + (((mem + len + 16) - _cursor) & ~size_t(15));
+      }
+
+      char* carve(size_t cls) {
+         const size_t bsize = block_size(cls);
+         if (static_cast<size_t>(_limit - _cursor) < bsize)
+            refill(bsize);
+         char* block = _cursor;
+         _cursor += bsize;
+         return block;
+      }
+
+      void* malloc_small(size_t cls) {
+         char* block;
+         if (free_block* fb = _bins[cls]) {
+            _bins[cls] = fb->next;
+            block = reinterpret_cast<char*>(fb) - _header_size;
+         } else {
+            block = carve(cls);
+         }
+         header* hdr = reinterpret_cast<header*>(block);
+         hdr->info = cls;
+         hdr->tag  = _alloc_tag;
+         return payload_of(block);
+      }
+
+      void* malloc_large(size_t size) {
+         const size_t bsize = (size + _header_size + 15) & ~size_t(15);
+
+         free_block* prev = nullptr;
+         for (free_block* fb = _large; fb != nullptr; prev = fb, fb = fb->next) {
+            header* hdr = header_of(fb);
+            if (hdr->info >= bsize) {
+               if (prev)
+                  prev->next = fb->next;
+               else
+                  _large = fb->next;
+               hdr->tag = _alloc_tag;
+               return fb;
+            }
+         }
+
+         char* mem = align_block(grow(bsize + 16));
+         header* hdr = reinterpret_cast<header*>(mem);
+         hdr->info = bsize;
+         hdr->tag  = _alloc_tag;
+         return payload_of(mem);
+      }
+
+      void* malloc(size_t size) {
+         if (size == 0)
+            return nullptr;
+         if (size > _max_small_block - _header_size)
+            return malloc_large(size);
+         return malloc_small(size_class(size));
+      }
+
+      static size_t capacity(header* hdr) {
+         return (hdr->info < _num_classes ? block_size(hdr->info) : hdr->info) - _header_size;
+      }
+
+      void* realloc(void* ptr, size_t size) {
+         if (size == 0) {
+            free(ptr);
+            return nullptr;
+         }
+         if (ptr == nullptr)
+            return malloc(size);
+
+         header* hdr = header_of(ptr);
+         eosio::check(hdr->tag == _alloc_tag, "realloc of invalid pointer");
+         const size_t orig_size = capacity(hdr);
+         if (size <= orig_size)
+            return ptr;
+
+         void* new_alloc = malloc(size);
+         memcpy(new_alloc, ptr, orig_size);
+         free(ptr);
+         return new_alloc;
+      }
+
+      void free(void* ptr) {
+         if (ptr == nullptr)
+            return;
+
+         header* hdr = header_of(ptr);
+         eosio::check(hdr->tag == _alloc_tag, "free of invalid pointer");
+         hdr->tag = _free_tag;
+         free_block* fb = static_cast<free_block*>(ptr);
+         if (hdr->info < _num_classes) {
+            fb->next = _bins[hdr->info];
+            _bins[hdr->info] = fb;
+         } else {
+            fb->next = _large;
+            _large = fb;
+         }
+      }
+
+      free_block* _bins[_num_classes];
+      free_block* _large;
+      char*       _cursor;
+      char*       _limit;
+   };
+
+   size_class_memory_manager size_class_heap;
+} /// namespace eosio
+
+extern "C" {
+void* malloc(size_t size) {
+   return eosio::size_class_heap.malloc(size);
+}
+
+void* calloc(size_t count, size_t size) {
+   if (size != 0 && count > size_t(-1) / size)
+      return nullptr;
+   void* ptr = eosio::size_class_heap.malloc(count*size);
+   if (ptr)
+      memset(ptr, 0, count*size);
+   return ptr;
+}
+
+void* realloc(void* ptr, size_t size) {
+   return eosio::size_class_heap.realloc(ptr, size);
+}
+
+void free(void* ptr) {
+   return eosio::size_class_heap.free(ptr);
+}
+}
@@ -0,0 +1,765 @@
+#include "native/eosio/chain_state.hpp"
+#include "native/eosio/intrinsics.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <map>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+using namespace eosio::native;
+
+/*
+ * eosio-profile (tools/external/wabt/src/tools/wasm-profile.cc) serves the db and kv host functions from a copy of this
+ * model, TableSet, PrimaryIndex, SecondaryIndex and KvDatabase there.  Keep the two in sync: a change to the iterator
+ * handles, the results or the checks here has to be made there as well.  chain_state_profile_test and
+ * tests/unit/profile_tests.sh make the same calls through both and expect the same values.
+ */
+namespace {
+   struct table_id {
+      uint64_t code;
+      uint64_t scope;
+      uint64_t table;
+
+      friend bool operator<(const table_id& a, const table_id& b) {
+         return std::tie(a.code, a.scope, a.table) < std::tie(b.code, b.scope, b.table);
+      }
+   };
+
+   uint64_t receiver_value = 0;
+
+   void check_receiver(uint64_t code) {
+      eosio::check(code == receiver_value, "db access violation");
+   }
+
+   struct no_extra {};
+
+   /*
+    * The tables of one kind (the primary tables, or the tables of one secondary index type) and the iterator handles
+    * handed out for them.  Rows is an ordered map whose mapped type records the row's handle in `itr`, so a row keeps
+    * a single handle however often it is looked up.  End iterators are -(n + 2) for the n-th table created and stay
+    * valid for as long as the state does.
+    */
+   template <typename Rows, typename Extra = no_extra>
+   class table_set {
+      public:
+         using row_iterator = typename Rows::iterator;
+
+         struct table : Extra {
+            table_id id;
+            Rows     rows;
+            int32_t  end_itr;
+         };
+
+         // tables without rows do not exist as far as the contract can tell
+         table* find(uint64_t code, uint64_t scope, uint64_t tbl) {
+            auto it = _tables.find(table_id{code, scope, tbl});
+            return it == _tables.end() || it->second.rows.empty() ? nullptr : &it->second;
+         }
+
+         table& find_or_create(uint64_t code, uint64_t scope, uint64_t tbl) {
+            auto [it, inserted] = _tables.try_emplace(table_id{code, scope, tbl});
+            if (inserted) {
+               it->second.id      = it->first;
+               it->second.end_itr = -int32_t(_ends.size()) - 2;
+               _ends.push_back(&it->second);
+            }
+            return it->second;
+         }
+
+         int32_t iterator_to(table& t, row_iterator row) {
+            if (row == t.rows.end())
+               return t.end_itr;
+            if (row->second.itr < 0) {
+               row->second.itr = _rows.size();
+               _rows.emplace_back(&t, row);
+            }
+            return row->second.itr;
+         }
+
+         std::pair<table*, row_iterator> get(int32_t itr) {
+            eosio::check(itr >= 0, "dereference of end iterator");
+            eosio::check(size_t(itr) < _rows.size(), "dereference of invalid iterator");
+            eosio::check(_rows[itr].first != nullptr, "dereference of deleted object");
+            return _rows[itr];
+         }
+
+         table& get_end(int32_t itr) {
+            eosio::check(itr < -1 && size_t(-(itr + 2)) < _ends.size(), "invalid end iterator");
+            return *_ends[-(itr + 2)];
+         }
+
+         void erase(int32_t itr) {
+            auto [t, row] = get(itr);
+            _rows[itr].first = nullptr;
+            t->rows.erase(row);
+         }
+
+         // moves the row behind `itr` to a new key, keeping its handle
+         void rekey(int32_t itr, const typename Rows::key_type& key) {
+            auto [t, row] = get(itr);
+            auto node = t->rows.extract(row);
+            node.key() = key;
+            _rows[itr].second = t->rows.insert(std::move(node)).position;
+         }
+
+         int32_t next(int32_t itr) {
+            if (itr < -1)
+               return -1;
+            auto [t, row] = get(itr);
+            return iterator_to(*t, ++row);
+         }
+
+         int32_t previous(int32_t itr) {
+            table*       t;
+            row_iterator row;
+            if (itr < -1) {
+               t   = &get_end(itr);
+               row = t->rows.end();
+            } else {
+               std::tie(t, row) = get(itr);
+            }
+            if (row == t->rows.begin())
+               return -1;
+            return iterator_to(*t, --row);
+         }
+
+         void clear() {
+            _tables.clear();
+            _ends.clear();
+            _rows.clear();
+         }
+
+      private:
+         std::map<table_id, table>                    _tables;
+         std::vector<table*>                          _ends;
+         std::vector<std::pair<table*, row_iterator>> _rows;
+   };
+
+   class primary_index {
+      public:
+         int32_t store(uint64_t scope, uint64_t table, uint64_t payer, uint64_t id, const void* data, uint32_t len) {
+            auto& t = _set.find_or_create(receiver_value, scope, table);
+            auto [row, inserted] = t.rows.try_emplace(id);
+            eosio::check(inserted, "db_store_i64: a row with this primary key already exists");
+            row->second.value.assign((const char*)data, (const char*)data + len);
+            row->second.payer = payer;
+            return _set.iterator_to(t, row);
+         }
+
+         void update(int32_t itr, uint64_t payer, const void* data, uint32_t len) {
+            auto [t, row] = _set.get(itr);
+            check_receiver(t->id.code);
+            row->second.value.assign((const char*)data, (const char*)data + len);
+            if (payer)
+               row->second.payer = payer;
+         }
+
+         void remove(int32_t itr) {
+            check_receiver(_set.get(itr).first->id.code);
+            _set.erase(itr);
+         }
+
+         int32_t get(int32_t itr, void* data, uint32_t len) {
+            const auto& value = _set.get(itr).second->second.value;
+            if (len == 0)
+               return value.size();
+            const uint32_t copy_size = std::min<size_t>(len, value.size());
+            memcpy(data, value.data(), copy_size);
+            return copy_size;
+         }
+
+         int32_t next(int32_t itr, uint64_t* primary) {
+            return with_primary(_set.next(itr), primary);
+         }
+
+         int32_t previous(int32_t itr, uint64_t* primary) {
+            return with_primary(_set.previous(itr), primary);
+         }
+
+         int32_t find(uint64_t code, uint64_t scope, uint64_t table, uint64_t id) {
+            auto t = _set.find(code, scope, table);
+            return t ? _set.iterator_to(*t, t->rows.find(id)) : -1;
+         }
+
+         int32_t lowerbound(uint64_t code, uint64_t scope, uint64_t table, uint64_t id) {
+            auto t = _set.find(code, scope, table);
+            return t ? _set.iterator_to(*t, t->rows.lower_bound(id)) : -1;
+         }
+
+         int32_t upperbound(uint64_t code, uint64_t scope, uint64_t table, uint64_t id) {
+            auto t = _set.find(code, scope, table);
+            return t ? _set.iterator_to(*t, t->rows.upper_bound(id)) : -1;
+         }
+
+         int32_t end(uint64_t code, uint64_t scope, uint64_t table) {
+            auto t = _set.find(code, scope, table);
+            return t ? t->end_itr : -1;
+         }
+
+         size_t size(uint64_t code, uint64_t scope, uint64_t table) {
+            auto t = _set.find(code, scope, table);
+            return t ? t->rows.size() : 0;
+         }
+
+         void clear() { _set.clear(); }
+
+      private:
+         struct row {
+            std::vector<char> value;
+            uint64_t          payer = 0;
+            int32_t           itr   = -1;
+         };
+
+         int32_t with_primary(int32_t itr, uint64_t* primary) {
+            if (itr >= 0)
+               *primary = _set.get(itr).second->first;
+            return itr;
+         }
+
+         table_set<std::map<uint64_t, row>> _set;
+   };
+
+   template <typename Secondary>
+   class secondary_index {
+      public:
+         int32_t store(uint64_t scope, uint64_t table, uint64_t payer, uint64_t id, const Secondary& secondary) {
+            check_key(secondary);
+            auto& t = _set.find_or_create(receiver_value, scope, table);
+            eosio::check(t.by_primary.emplace(id, secondary).second, "secondary index already holds this primary key");
+            auto row = t.rows.emplace(key_type{secondary, id}, row_type{payer}).first;
+            return _set.iterator_to(t, row);
+         }
+
+         void update(int32_t itr, uint64_t payer, const Secondary& secondary) {
+            check_key(secondary);
+            auto [t, row] = _set.get(itr);
+            check_receiver(t->id.code);
+            const uint64_t primary = row->first.second;
+            if (payer)
+               row->second.payer = payer;
+            t->by_primary[primary] = secondary;
+            _set.rekey(itr, key_type{secondary, primary});
+         }
+
+         void remove(int32_t itr) {
+            auto [t, row] = _set.get(itr);
+            check_receiver(t->id.code);
+            t->by_primary.erase(row->first.second);
+            _set.erase(itr);
+         }
+
+         int32_t next(int32_t itr, uint64_t* primary) {
+            return with_primary(_set.next(itr), primary);
+         }
+
+         int32_t previous(int32_t itr, uint64_t* primary) {
+            return with_primary(_set.previous(itr), primary);
+         }
+
+         int32_t find_primary(uint64_t code, uint64_t scope, uint64_t table, Secondary& secondary, uint64_t primary) {
+            auto t = _set.find(code, scope, table);
+            if (!t)
+               return -1;
+            auto by_primary = t->by_primary.find(primary);
+            if (by_primary == t->by_primary.end())
+               return t->end_itr;
+            secondary = by_primary->second;
+            return _set.iterator_to(*t, t->rows.find(key_type{secondary, primary}));
+         }
+
+         int32_t find_secondary(uint64_t code, uint64_t scope, uint64_t table, const Secondary& secondary, uint64_t* primary) {
+            auto t = _set.find(code, scope, table);
+            if (!t)
+               return -1;
+            auto row = t->rows.lower_bound(key_type{secondary, 0});
+            if (row == t->rows.end() || secondary < row->first.first)
+               return t->end_itr;
+            *primary = row->first.second;
+            return _set.iterator_to(*t, row);
+         }
+
+         int32_t lowerbound(uint64_t code, uint64_t scope, uint64_t table, Secondary& secondary, uint64_t* primary) {
+            auto t = _set.find(code, scope, table);
+            return t ? at(*t, t->rows.lower_bound(key_type{secondary, 0}), secondary, primary) : -1;
+         }
+
+         int32_t upperbound(uint64_t code, uint64_t scope, uint64_t table, Secondary& secondary, uint64_t* primary) {
+            auto t = _set.find(code, scope, table);
+            const auto key = key_type{secondary, std::numeric_limits<uint64_t>::max()};
+            return t ? at(*t, t->rows.upper_bound(key), secondary, primary) : -1;
+         }
+
+         int32_t end(uint64_t code, uint64_t scope, uint64_t table) {
+            auto t = _set.find(code, scope, table);
+            return t ? t->end_itr : -1;
+         }
+
+         void clear() { _set.clear(); }
+
+      private:
+         using key_type = std::pair<Secondary, uint64_t>;
+
+         struct row_type {
+            uint64_t payer = 0;
+            int32_t  itr   = -1;
+         };
+
+         struct by_primary_map {
+            std::map<uint64_t, Secondary> by_primary;
+         };
+
+         using set_type = table_set<std::map<key_type, row_type>, by_primary_map>;
+
+         static void check_key(const Secondary& secondary) {
+            if constexpr (std::is_floating_point_v<Secondary>)
+               eosio::check(!std::isnan(secondary), "NaN is not an allowed value for a secondary key");
+         }
+
+         int32_t at(typename set_type::table& t, typename set_type::row_iterator row, Secondary& secondary, uint64_t* primary) {
+            if (row != t.rows.end()) {
+               secondary = row->first.first;
+               *primary  = row->first.second;
+            }
+            return _set.iterator_to(t, row);
+         }
+
+         int32_t with_primary(int32_t itr, uint64_t* primary) {
+            if (itr >= 0)
+               *primary = _set.get(itr).second->first.second;
+            return itr;
+         }
+
+         set_type _set;
+   };
+
+   using key256 = std::array<uint128_t, 2>;
+
+   key256 to_key256(const uint128_t* data, uint32_t data_len) {
+      eosio::check(data_len == 2, "invalid size of secondary key array for idx256");
+      return key256{data[0], data[1]};
+   }
+
+   void from_key256(const key256& key, uint128_t* data) {
+      data[0] = key[0];
+      data[1] = key[1];
+   }
+
+   /*
+    * One ordered byte map per contract.  Iterators remember the key they are positioned at rather than a map iterator,
+    * which lets them report that their key-value pair was erased the way nodeos does.
+    */
+   class kv_database {
+      public:
+         static constexpr int32_t iterator_ok     = 0;
+         static constexpr int32_t iterator_erased = -1;
+         static constexpr int32_t iterator_end    = -2;
+
+         int64_t erase(uint64_t contract, const char* key, uint32_t key_size) {
+            eosio::check(contract == receiver_value, "Can not write to this key");
+            auto& db = _dbs[contract];
+            auto  it = db.find(std::string_view(key, key_size));
+            if (it == db.end())
+               return 0;
+            const int64_t delta = -int64_t(it->first.size() + it->second.size());
+            db.erase(it);
+            return delta;
+         }
+
+         int64_t set(uint64_t contract, const char* key, uint32_t key_size, const char* value, uint32_t value_size) {
+            eosio::check(contract == receiver_value, "Can not write to this key");
+            auto [it, inserted] = _dbs[contract].try_emplace(std::string(key, key_size));
+            const int64_t delta = inserted ? int64_t(key_size) + value_size : int64_t(value_size) - int64_t(it->second.size());
+            it->second.assign(value, value_size);
+            return delta;
+         }
+
+         bool get(uint64_t contract, const char* key, uint32_t key_size, uint32_t& value_size) {
+            auto& db = _dbs[contract];
+            auto  it = db.find(std::string_view(key, key_size));
+            if (it == db.end()) {
+               _value.clear();
+               value_size = 0;
+               return false;
+            }
+            _value     = it->second;
+            value_size = _value.size();
+            return true;
+         }
+
+         uint32_t get_data(uint32_t offset, char* data, uint32_t data_size) {
+            if (offset < _value.size())
+               memcpy(data, _value.data() + offset, std::min<size_t>(data_size, _value.size() - offset));
+            return _value.size();
+         }
+
+         // handles start at 1, kv::table treats 0 as "no iterator"
+         uint32_t it_create(uint64_t contract, const char* prefix, uint32_t size) {
+            uint32_t handle;
+            if (_free.empty()) {
+               _iterators.emplace_back();
+               handle = _iterators.size();
+            } else {
+               handle = _free.back();
+               _free.pop_back();
+            }
+            auto& it    = _iterators[handle - 1];
+            it.live     = true;
+            it.contract = contract;
+            it.prefix.assign(prefix, size);
+            it.at_end   = true;
+            it.key.clear();
+            return handle;
+         }
+
+         void it_destroy(uint32_t itr) {
+            iterator(itr).live = false;
+            _free.push_back(itr);
+         }
+
+         int32_t it_status(uint32_t itr) {
+            return status(iterator(itr));
+         }
+
+         int32_t it_compare(uint32_t itr_a, uint32_t itr_b) {
+            auto& a = iterator(itr_a);
+            auto& b = iterator(itr_b);
+            eosio::check(a.contract == b.contract && a.prefix == b.prefix, "Incompatible key-value iterators");
+            check_not_erased(a);
+            check_not_erased(b);
+            if (a.at_end || b.at_end)
+               return int32_t(a.at_end) - int32_t(b.at_end);
+            return sign(a.key.compare(b.key));
+         }
+
+         int32_t it_key_compare(uint32_t itr, const char* key, uint32_t size) {
+            auto& it = iterator(itr);
+            check_not_erased(it);
+            if (it.at_end)
+               return 1;
+            return sign(std::string_view(it.key).compare(std::string_view(key, size)));
+         }
+
+         int32_t it_move_to_end(uint32_t itr) {
+            iterator(itr).at_end = true;
+            return iterator_end;
+         }
+
+         int32_t it_next(uint32_t itr, uint32_t& found_key_size, uint32_t& found_value_size) {
+            auto& it = iterator(itr);
+            check_not_erased(it);
+            auto& db = _dbs[it.contract];
+            return move_to(it, it.at_end ? db.lower_bound(it.prefix) : db.upper_bound(it.key), found_key_size, found_value_size);
+         }
+
+         int32_t it_prev(uint32_t itr, uint32_t& found_key_size, uint32_t& found_value_size) {
+            auto& it  = iterator(itr);
+            check_not_erased(it);
+            auto& db  = _dbs[it.contract];
+            auto  pos = it.at_end ? prefix_end(db, it.prefix) : db.lower_bound(it.key);
+            if (pos == db.begin())
+               return move_to(it, db.end(), found_key_size, found_value_size);
+            return move_to(it, --pos, found_key_size, found_value_size);
+         }
+
+         int32_t it_lower_bound(uint32_t itr, const char* key, uint32_t size, uint32_t& found_key_size, uint32_t& found_value_size) {
+            auto& it = iterator(itr);
+            auto& db = _dbs[it.contract];
+            const std::string_view k(key, size);
+            return move_to(it, db.lower_bound(std::max(k, std::string_view(it.prefix))), found_key_size, found_value_size);
+         }
+
+         int32_t it_key(uint32_t itr, uint32_t offset, char* dest, uint32_t size, uint32_t& actual_size) {
+            auto& it = iterator(itr);
+            const int32_t stat = status(it);
+            if (stat != iterator_ok) {
+               actual_size = 0;
+               return stat;
+            }
+            return copy_out(it.key, offset, dest, size, actual_size);
+         }
+
+         int32_t it_value(uint32_t itr, uint32_t offset, char* dest, uint32_t size, uint32_t& actual_size) {
+            auto& it = iterator(itr);
+            const int32_t stat = status(it);
+            if (stat != iterator_ok) {
+               actual_size = 0;
+               return stat;
+            }
+            return copy_out(_dbs[it.contract].find(it.key)->second, offset, dest, size, actual_size);
+         }
+
+         size_t size(uint64_t contract) {
+            auto db = _dbs.find(contract);
+            return db == _dbs.end() ? 0 : db->second.size();
+         }
+
+         void clear() {
+            _dbs.clear();
+            _value.clear();
+            _iterators.clear();
+            _free.clear();
+         }
+
+      private:
+         using database = std::map<std::string, std::string, std::less<>>;
+
+         struct kv_iterator {
+            bool        live = false;
+            uint64_t    contract = 0;
+            std::string prefix;
+            bool        at_end = true;
+            std::string key;
+         };
+
+         static int32_t sign(int c) { return c < 0 ? -1 : c > 0 ? 1 : 0; }
+
+         static bool has_prefix(std::string_view key, std::string_view prefix) {
+            return key.substr(0, prefix.size()) == prefix;
+         }
+
+         // first key past every key that starts with `prefix`
+         static database::iterator prefix_end(database& db, std::string prefix) {
+            while (!prefix.empty() && (unsigned char)prefix.back() == 0xff)
+               prefix.pop_back();
+            if (prefix.empty())
+               return db.end();
+            ++prefix.back();
+            return db.lower_bound(prefix);
+         }
+
+         static int32_t copy_out(const std::string& src, uint32_t offset, char* dest, uint32_t size, uint32_t& actual_size) {
+            if (offset < src.size() && size > 0)
+               memcpy(dest, src.data() + offset, std::min<size_t>(size, src.size() - offset));
+            actual_size = src.size();
+            return iterator_ok;
+         }
+
+         kv_iterator& iterator(uint32_t itr) {
+            eosio::check(itr > 0 && itr <= _iterators.size() && _iterators[itr - 1].live, "Bad key-value iterator");
+            return _iterators[itr - 1];
+         }
+
+         int32_t status(const kv_iterator& it) {
+            if (it.at_end)
+               return iterator_end;
+            const auto& db = _dbs[it.contract];
+            return db.find(it.key) == db.end() ? iterator_erased : iterator_ok;
+         }
+
+         void check_not_erased(const kv_iterator& it) {
+            eosio::check(status(it) != iterator_erased, "Iterator to erased element");
+         }
+
+         int32_t move_to(kv_iterator& it, database::iterator pos, uint32_t& found_key_size, uint32_t& found_value_size) {
+            if (pos == _dbs[it.contract].end() || !has_prefix(pos->first, it.prefix)) {
+               it.at_end        = true;
+               found_key_size   = 0;
+               found_value_size = 0;
+               return iterator_end;
+            }
+            it.at_end        = false;
+            it.key           = pos->first;
+            found_key_size   = pos->first.size();
+            found_value_size = pos->second.size();
+            return iterator_ok;
+         }
+
+         std::map<uint64_t, database> _dbs;
+         std::string                  _value;
+         std::vector<kv_iterator>     _iterators;
+         std::vector<uint32_t>        _free;
+   };
+
+   primary_index                  idx_i64;
+   secondary_index<uint64_t>      idx64;
+   secondary_index<uint128_t>     idx128;
+   secondary_index<key256>        idx256;
+   secondary_index<double>        idx_double;
+   secondary_index<long double>   idx_long_double;
+   kv_database                    kv_db;
+} // ns anonymous
+
+// idx64, idx128, idx_double and idx_long_double all pass their key by pointer
+#define INSTALL_SECONDARY_INDEX(IDX, INDEX, TYPE)                                                                      \
+   intrinsics::set_intrinsic<intrinsics::db_##IDX##_store>(                                                           \
+      [](uint64_t scope, capi_name table, capi_name payer, uint64_t id, const TYPE* secondary) {                      \
+         return INDEX.store(scope, table, payer, id, *secondary);                                                     \
+      });                                                                                                             \
+   intrinsics::set_intrinsic<intrinsics::db_##IDX##_remove>([](int32_t itr) { INDEX.remove(itr); });                  \
+   intrinsics::set_intrinsic<intrinsics::db_##IDX##_update>(                                                          \
+      [](int32_t itr, capi_name payer, const TYPE* secondary) { INDEX.update(itr, payer, *secondary); });             \
+   intrinsics::set_intrinsic<intrinsics::db_##IDX##_find_primary>(                                                    \
+      [](capi_name code, uint64_t scope, capi_name table, TYPE* secondary, uint64_t primary) {                        \
+         return INDEX.find_primary(code, scope, table, *secondary, primary);                                          \
+      });                                                                                                             \
+   intrinsics::set_intrinsic<intrinsics::db_##IDX##_find_secondary>(                                                  \
+      [](capi_name code, uint64_t scope, capi_name table, const TYPE* secondary, uint64_t* primary) {                 \
+         return INDEX.find_secondary(code, scope, table, *secondary, primary);                                        \
+      });                                                                                                             \
+   intrinsics::set_intrinsic<intrinsics::db_##IDX##_lowerbound>(                                                      \
+      [](capi_name code, uint64_t scope, capi_name table, TYPE* secondary, uint64_t* primary) {                       \
+         return INDEX.lowerbound(code, scope, table, *secondary, primary);                                            \
+      });                                                                                                             \
+   intrinsics::set_intrinsic<intrinsics::db_##IDX##_upperbound>(                                                      \
+      [](capi_name code, uint64_t scope, capi_name table, TYPE* secondary, uint64_t* primary) {                       \
+         return INDEX.upperbound(code, scope, table, *secondary, primary);                                            \
+      });                                                                                                             \
+   intrinsics::set_intrinsic<intrinsics::db_##IDX##_end>(                                                             \
+      [](capi_name code, uint64_t scope, capi_name table) { return INDEX.end(code, scope, table); });                 \
+   intrinsics::set_intrinsic<intrinsics::db_##IDX##_next>(                                                            \
+      [](int32_t itr, uint64_t* primary) { return INDEX.next(itr, primary); });                                       \
+   intrinsics::set_intrinsic<intrinsics::db_##IDX##_previous>(                                                        \
+      [](int32_t itr, uint64_t* primary) { return INDEX.previous(itr, primary); });
+
+namespace eosio { namespace native {
+
+   void chain_state::install(eosio::name receiver) {
+      set_receiver(receiver);
+
+      intrinsics::set_intrinsic<intrinsics::current_receiver>([]() { return receiver_value; });
+
+      intrinsics::set_intrinsic<intrinsics::db_store_i64>(
+         [](uint64_t scope, capi_name table, capi_name payer, uint64_t id, const void* data, uint32_t len) {
+            return idx_i64.store(scope, table, payer, id, data, len);
+         });
+      intrinsics::set_intrinsic<intrinsics::db_update_i64>(
+         [](int32_t itr, capi_name payer, const void* data, uint32_t len) { idx_i64.update(itr, payer, data, len); });
+      intrinsics::set_intrinsic<intrinsics::db_remove_i64>([](int32_t itr) { idx_i64.remove(itr); });
+      intrinsics::set_intrinsic<intrinsics::db_get_i64>(
+         [](int32_t itr, const void* data, uint32_t len) { return idx_i64.get(itr, const_cast<void*>(data), len); });
+      intrinsics::set_intrinsic<intrinsics::db_next_i64>(
+         [](int32_t itr, uint64_t* pk) { return idx_i64.next(itr, pk); });
+      intrinsics::set_intrinsic<intrinsics::db_previous_i64>(
+         [](int32_t itr, uint64_t* pk) { return idx_i64.previous(itr, pk); });
+      intrinsics::set_intrinsic<intrinsics::db_find_i64>(
+         [](capi_name code, uint64_t scope, capi_name table, uint64_t id) { return idx_i64.find(code, scope, table, id); });
+      intrinsics::set_intrinsic<intrinsics::db_lowerbound_i64>(
+         [](capi_name code, uint64_t scope, capi_name table, uint64_t id) { return idx_i64.lowerbound(code, scope, table, id); });
+      intrinsics::set_intrinsic<intrinsics::db_upperbound_i64>(
+         [](capi_name code, uint64_t scope, capi_name table, uint64_t id) { return idx_i64.upperbound(code, scope, table, id); });
+      intrinsics::set_intrinsic<intrinsics::db_end_i64>(
+         [](capi_name code, uint64_t scope, capi_name table) { return idx_i64.end(code, scope, table); });
+
+      INSTALL_SECONDARY_INDEX(idx64, idx64, uint64_t)
+      INSTALL_SECONDARY_INDEX(idx128, idx128, uint128_t)
+      INSTALL_SECONDARY_INDEX(idx_double, idx_double, double)
+      INSTALL_SECONDARY_INDEX(idx_long_double, idx_long_double, long double)
+
+      intrinsics::set_intrinsic<intrinsics::db_idx256_store>(
+         [](uint64_t scope, capi_name table, capi_name payer, uint64_t id, const uint128_t* data, uint32_t data_len) {
+            return idx256.store(scope, table, payer, id, to_key256(data, data_len));
+         });
+      intrinsics::set_intrinsic<intrinsics::db_idx256_remove>([](int32_t itr) { idx256.remove(itr); });
+      intrinsics::set_intrinsic<intrinsics::db_idx256_update>(
+         [](int32_t itr, capi_name payer, const uint128_t* data, uint32_t data_len) {
+            idx256.update(itr, payer, to_key256(data, data_len));
+         });
+      intrinsics::set_intrinsic<intrinsics::db_idx256_find_primary>(
+         [](capi_name code, uint64_t scope, capi_name table, uint128_t* data, uint32_t data_len, uint64_t primary) {
+            key256 key = to_key256(data, data_len);
+            const int32_t itr = idx256.find_primary(code, scope, table, key, primary);
+            from_key256(key, data);
+            return itr;
+         });
+      intrinsics::set_intrinsic<intrinsics::db_idx256_find_secondary>(
+         [](capi_name code, uint64_t scope, capi_name table, const uint128_t* data, uint32_t data_len, uint64_t* primary) {
+            return idx256.find_secondary(code, scope, table, to_key256(data, data_len), primary);
+         });
+      intrinsics::set_intrinsic<intrinsics::db_idx256_lowerbound>(
+         [](capi_name code, uint64_t scope, capi_name table, uint128_t* data, uint32_t data_len, uint64_t* primary) {
+            key256 key = to_key256(data, data_len);
+            const int32_t itr = idx256.lowerbound(code, scope, table, key, primary);
+            from_key256(key, data);
+            return itr;
+         });
+      intrinsics::set_intrinsic<intrinsics::db_idx256_upperbound>(
+         [](capi_name code, uint64_t scope, capi_name table, uint128_t* data, uint32_t data_len, uint64_t* primary) {
+            key256 key = to_key256(data, data_len);
+            const int32_t itr = idx256.upperbound(code, scope, table, key, primary);
+            from_key256(key, data);
+            return itr;
+         });
+      intrinsics::set_intrinsic<intrinsics::db_idx256_end>(
+         [](capi_name code, uint64_t scope, capi_name table) { return idx256.end(code, scope, table); });
+      intrinsics::set_intrinsic<intrinsics::db_idx256_next>(
+         [](int32_t itr, uint64_t* primary) { return idx256.next(itr, primary); });
+      intrinsics::set_intrinsic<intrinsics::db_idx256_previous>(
+         [](int32_t itr, uint64_t* primary) { return idx256.previous(itr, primary); });
+
+      intrinsics::set_intrinsic<intrinsics::kv_erase>(
+         [](uint64_t contract, const char* key, uint32_t key_size) { return kv_db.erase(contract, key, key_size); });
+      intrinsics::set_intrinsic<intrinsics::kv_set>(
+         [](uint64_t contract, const char* key, uint32_t key_size, const char* value, uint32_t value_size, uint64_t payer) {
+            return kv_db.set(contract, key, key_size, value, value_size);
+         });
+      intrinsics::set_intrinsic<intrinsics::kv_get>(
+         [](uint64_t contract, const char* key, uint32_t key_size, uint32_t& value_size) {
+            return kv_db.get(contract, key, key_size, value_size);
+         });
+      intrinsics::set_intrinsic<intrinsics::kv_get_data>(
+         [](uint32_t offset, char* data, uint32_t data_size) { return kv_db.get_data(offset, data, data_size); });
+      intrinsics::set_intrinsic<intrinsics::kv_it_create>(
+         [](uint64_t contract, const char* prefix, uint32_t size) { return kv_db.it_create(contract, prefix, size); });
+      intrinsics::set_intrinsic<intrinsics::kv_it_destroy>([](uint32_t itr) { kv_db.it_destroy(itr); });
+      intrinsics::set_intrinsic<intrinsics::kv_it_status>([](uint32_t itr) { return kv_db.it_status(itr); });
+      intrinsics::set_intrinsic<intrinsics::kv_it_compare>(
+         [](uint32_t itr_a, uint32_t itr_b) { return kv_db.it_compare(itr_a, itr_b); });
+      intrinsics::set_intrinsic<intrinsics::kv_it_key_compare>(
+         [](uint32_t itr, const char* key, uint32_t size) { return kv_db.it_key_compare(itr, key, size); });
+      intrinsics::set_intrinsic<intrinsics::kv_it_move_to_end>([](uint32_t itr) { return kv_db.it_move_to_end(itr); });
+      intrinsics::set_intrinsic<intrinsics::kv_it_next>(
+         [](uint32_t itr, uint32_t& found_key_size, uint32_t& found_value_size) {
+            return kv_db.it_next(itr, found_key_size, found_value_size);
+         });
+      intrinsics::set_intrinsic<intrinsics::kv_it_prev>(
+         [](uint32_t itr, uint32_t& found_key_size, uint32_t& found_value_size) {
+            return kv_db.it_prev(itr, found_key_size, found_value_size);
+         });
+      intrinsics::set_intrinsic<intrinsics::kv_it_lower_bound>(
+         [](uint32_t itr, const char* key, uint32_t size, uint32_t& found_key_size, uint32_t& found_value_size) {
+            return kv_db.it_lower_bound(itr, key, size, found_key_size, found_value_size);
+         });
+      intrinsics::set_intrinsic<intrinsics::kv_it_key>(
+         [](uint32_t itr, uint32_t offset, char* dest, uint32_t size, uint32_t& actual_size) {
+            return kv_db.it_key(itr, offset, dest, size, actual_size);
+         });
+      intrinsics::set_intrinsic<intrinsics::kv_it_value>(
+         [](uint32_t itr, uint32_t offset, char* dest, uint32_t size, uint32_t& actual_size) {
+            return kv_db.it_value(itr, offset, dest, size, actual_size);
+         });
+   }
+
+   void chain_state::set_receiver(eosio::name receiver) {
+      receiver_value = receiver.value;
+   }
+
+   eosio::name chain_state::receiver() {
+      return eosio::name{receiver_value};
+   }
+
+   void chain_state::reset() {
+      idx_i64.clear();
+      idx64.clear();
+      idx128.clear();
+      idx256.clear();
+      idx_double.clear();
+      idx_long_double.clear();
+      kv_db.clear();
+   }
+
+   std::size_t chain_state::row_count(eosio::name code, uint64_t scope, eosio::name table) {
+      return idx_i64.size(code.value, scope, table.value);
+   }
+
+   std::size_t chain_state::kv_size(eosio::name contract) {
+      return kv_db.size(contract.value);
+   }
+
+}} //ns eosio::native
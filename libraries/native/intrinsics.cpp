@@ -910,3 +910,54 @@ extern "C" {
    }
 
 }
+
+// the kv intrinsics take their out-params by reference, so they keep the declarations from map.hpp
+namespace eosio { namespace kv { namespace internal_use_do_not_use {
+extern "C" {
+   int64_t kv_erase(uint64_t contract, const char* key, uint32_t key_size) {
+      return intrinsics::get().call<intrinsics::kv_erase>(contract, key, key_size);
+   }
+   int64_t kv_set(uint64_t contract, const char* key, uint32_t key_size, const char* value, uint32_t value_size, uint64_t payer) {
+      return intrinsics::get().call<intrinsics::kv_set>(contract, key, key_size, value, value_size, payer);
+   }
+   bool kv_get(uint64_t contract, const char* key, uint32_t key_size, uint32_t& value_size) {
+      return intrinsics::get().call<intrinsics::kv_get>(contract, key, key_size, value_size);
+   }
+   uint32_t kv_get_data(uint32_t offset, char* data, uint32_t data_size) {
+      return intrinsics::get().call<intrinsics::kv_get_data>(offset, data, data_size);
+   }
+   uint32_t kv_it_create(uint64_t contract, const char* prefix, uint32_t size) {
+      return intrinsics::get().call<intrinsics::kv_it_create>(contract, prefix, size);
+   }
+   void kv_it_destroy(uint32_t itr) {
+      return intrinsics::get().call<intrinsics::kv_it_destroy>(itr);
+   }
+   int32_t kv_it_status(uint32_t itr) {
+      return intrinsics::get().call<intrinsics::kv_it_status>(itr);
+   }
+   int32_t kv_it_compare(uint32_t itr_a, uint32_t itr_b) {
+      return intrinsics::get().call<intrinsics::kv_it_compare>(itr_a, itr_b);
+   }
+   int32_t kv_it_key_compare(uint32_t itr, const char* key, uint32_t size) {
+      return intrinsics::get().call<intrinsics::kv_it_key_compare>(itr, key, size);
+   }
+   int32_t kv_it_move_to_end(uint32_t itr) {
+      return intrinsics::get().call<intrinsics::kv_it_move_to_end>(itr);
+   }
+   int32_t kv_it_next(uint32_t itr, uint32_t& found_key_size, uint32_t& found_value_size) {
+      return intrinsics::get().call<intrinsics::kv_it_next>(itr, found_key_size, found_value_size);
+   }
+   int32_t kv_it_prev(uint32_t itr, uint32_t& found_key_size, uint32_t& found_value_size) {
+      return intrinsics::get().call<intrinsics::kv_it_prev>(itr, found_key_size, found_value_size);
+   }
+   int32_t kv_it_lower_bound(uint32_t itr, const char* key, uint32_t size, uint32_t& found_key_size, uint32_t& found_value_size) {
+      return intrinsics::get().call<intrinsics::kv_it_lower_bound>(itr, key, size, found_key_size, found_value_size);
+   }
+   int32_t kv_it_key(uint32_t itr, uint32_t offset, char* dest, uint32_t size, uint32_t& actual_size) {
+      return intrinsics::get().call<intrinsics::kv_it_key>(itr, offset, dest, size, actual_size);
+   }
+   int32_t kv_it_value(uint32_t itr, uint32_t offset, char* dest, uint32_t size, uint32_t& actual_size) {
+      return intrinsics::get().call<intrinsics::kv_it_value>(itr, offset, dest, size, actual_size);
+   }
+}
+}}} //ns eosio::kv::internal_use_do_not_use
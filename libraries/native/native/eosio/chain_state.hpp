@@ -0,0 +1,39 @@
+#pragma once
+#include <eosio/name.hpp>
+
+#include <cstddef>
+
+namespace eosio { namespace native {
+
+   /**
+    * In-memory chain state backing the database intrinsics of native unit tests.
+    *
+    * `install` routes the db_* (i64, idx64, idx128, idx256, idx_double and idx_long_double) and kv_* intrinsics, along
+    * with current_receiver, to an in-process store, so multi_index, kv::table and kv::map code runs natively without a
+    * hand written fake.  Tables are ordered maps keyed by (code, scope, table) and follow nodeos' iterator conventions:
+    * non-negative handles name rows, each table has its own negative end iterator and -1 means no such table.  The KV
+    * store keeps one ordered byte map per contract with prefix iterators.
+    *
+    * Writes go to the tables and KV database of the current receiver, mirroring what the contract is allowed to do
+    * on chain.  The state lives until `reset` and is shared by every test in the executable.
+    */
+   class chain_state {
+      public:
+         /// Installs the store's intrinsics and sets the receiver that writes are charged to
+         static void install(eosio::name receiver);
+
+         /// Changes the current receiver without touching any stored data
+         static void set_receiver(eosio::name receiver);
+         static eosio::name receiver();
+
+         /// Drops every row, KV pair and outstanding iterator
+         static void reset();
+
+         /// Number of rows in a primary table, 0 if it does not exist
+         static std::size_t row_count(eosio::name code, uint64_t scope, eosio::name table);
+
+         /// Number of key-value pairs in a contract's KV database
+         static std::size_t kv_size(eosio::name contract);
+   };
+
+}} //ns eosio::native
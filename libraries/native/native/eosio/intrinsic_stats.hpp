@@ -0,0 +1,90 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace eosio { namespace native {
+
+   /**
+    * Counters kept for a single intrinsic while statistics are enabled.
+    *
+    * `bytes` counts the buffers handed to the intrinsic, i.e. every pointer argument that is directly followed by a
+    * uint32_t length, scaled by the size of the pointee.  Bucket `i` of the histogram counts the calls that took
+    * between 2^i and 2^(i+1) nanoseconds, the first bucket also holds calls that took less than a nanosecond and the
+    * last one everything longer than it covers.
+    */
+   struct intrinsic_stats {
+      static constexpr std::size_t histogram_buckets = 32;
+
+      uint64_t calls       = 0;
+      uint64_t bytes       = 0;
+      uint64_t nanoseconds = 0;
+      std::array<uint64_t, histogram_buckets> histogram = {};
+
+      void record_time(uint64_t ns) {
+         nanoseconds += ns;
+         std::size_t bucket = 0;
+         while (ns > 1 && bucket + 1 < histogram_buckets) {
+            ns >>= 1;
+            ++bucket;
+         }
+         ++histogram[bucket];
+      }
+
+      intrinsic_stats& operator-=(const intrinsic_stats& o) {
+         calls       -= o.calls;
+         bytes       -= o.bytes;
+         nanoseconds -= o.nanoseconds;
+         for (std::size_t i = 0; i < histogram_buckets; ++i)
+            histogram[i] -= o.histogram[i];
+         return *this;
+      }
+   };
+
+   namespace detail {
+      template <typename T>
+      constexpr uint64_t pointee_size() {
+         using pointee = std::remove_cv_t<std::remove_pointer_t<T>>;
+         if constexpr (std::is_void_v<pointee>)
+            return 1;
+         else
+            return sizeof(pointee);
+      }
+
+      inline uint64_t bytes_moved() { return 0; }
+
+      template <typename T>
+      inline uint64_t bytes_moved(const T&) { return 0; }
+
+      template <typename T, typename U, typename... Rest>
+      inline uint64_t bytes_moved(const T& a, const U& b, const Rest&... rest) {
+         uint64_t moved = 0;
+         if constexpr (std::is_pointer_v<T> && std::is_same_v<U, uint32_t>)
+            moved = a ? b * pointee_size<T>() : 0;
+         return moved + bytes_moved(b, rest...);
+      }
+
+      // charges a call to its intrinsic on construction and its wall time on destruction
+      class intrinsic_timer {
+         public:
+            intrinsic_timer(intrinsic_stats& stats, uint64_t bytes)
+               : _stats(stats), _start(std::chrono::steady_clock::now()) {
+               ++_stats.calls;
+               _stats.bytes += bytes;
+            }
+
+            ~intrinsic_timer() {
+               const auto elapsed = std::chrono::steady_clock::now() - _start;
+               _stats.record_time(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+            }
+
+         private:
+            intrinsic_stats&                      _stats;
+            std::chrono::steady_clock::time_point _start;
+      };
+   } // ns eosio::native::detail
+
+}} //ns eosio::native
@@ -1,5 +1,9 @@
 #include <eosio/action.hpp>
 #include "intrinsics_def.hpp"
+#include "intrinsic_stats.hpp"
+
+#include <string>
+#include <string_view>
 
 #pragma once
 
@@ -23,9 +27,93 @@ namespace eosio { namespace native {
             std::function<void()>{[](){}}
          };
 
+         /**
+          * Statistics of every intrinsic at one point in time, see `snapshot_stats`.  Subtracting an earlier snapshot
+          * gives the calls made in between, which is how tests put a budget on the host calls of an action.
+          */
+         class stats_snapshot {
+            public:
+               const intrinsic_stats& operator[](intrinsic_name in) const { return _stats[in]; }
+
+               /// Calls made to the intrinsics whose name starts with `prefix`, e.g. "kv_" or "db_idx64_"
+               uint64_t calls(std::string_view prefix = {}) const {
+                  uint64_t total = 0;
+                  for (std::size_t i = 0; i < INTRINSICS_SIZE; ++i)
+                     if (std::string_view(name_of(intrinsic_name(i))).substr(0, prefix.size()) == prefix)
+                        total += _stats[i].calls;
+                  return total;
+               }
+
+               /// Bytes passed to the intrinsics whose name starts with `prefix`
+               uint64_t bytes(std::string_view prefix = {}) const {
+                  uint64_t total = 0;
+                  for (std::size_t i = 0; i < INTRINSICS_SIZE; ++i)
+                     if (std::string_view(name_of(intrinsic_name(i))).substr(0, prefix.size()) == prefix)
+                        total += _stats[i].bytes;
+                  return total;
+               }
+
+               stats_snapshot operator-(const stats_snapshot& earlier) const {
+                  stats_snapshot diff = *this;
+                  for (std::size_t i = 0; i < INTRINSICS_SIZE; ++i)
+                     diff._stats[i] -= earlier._stats[i];
+                  return diff;
+               }
+
+               /// JSON object keyed by intrinsic name, intrinsics that were never called are left out
+               std::string to_json() const {
+                  std::string json = "{";
+                  for (std::size_t i = 0; i < INTRINSICS_SIZE; ++i) {
+                     const auto& s = _stats[i];
+                     if (s.calls == 0)
+                        continue;
+                     if (json.size() > 1)
+                        json += ",";
+                     json += std::string("\"") + name_of(intrinsic_name(i)) + "\":{\"calls\":" + std::to_string(s.calls) +
+                             ",\"bytes\":" + std::to_string(s.bytes) + ",\"ns\":" + std::to_string(s.nanoseconds) +
+                             ",\"histogram\":[";
+                     std::size_t used = s.histogram.size();
+                     while (used > 1 && s.histogram[used - 1] == 0)
+                        --used;
+                     for (std::size_t b = 0; b < used; ++b)
+                        json += (b ? "," : "") + std::to_string(s.histogram[b]);
+                     json += "]}";
+                  }
+                  return json + "}";
+               }
+
+            private:
+               friend class intrinsics;
+               std::array<intrinsic_stats, INTRINSICS_SIZE> _stats = {};
+         };
+
          template <intrinsic_name IN, typename... Args>
-         auto call(Args... args) -> decltype(std::get<IN>(intrinsics::get().funcs)(args...)) {
-            return std::get<IN>(intrinsics::get().funcs)(args...); 
+         auto call(Args&&... args) -> decltype(std::get<IN>(intrinsics::get().funcs)(std::forward<Args>(args)...)) {
+            auto& self = intrinsics::get();
+            if (!self.stats_enabled)
+               return std::get<IN>(self.funcs)(std::forward<Args>(args)...);
+            detail::intrinsic_timer timer{self.stats._stats[IN], detail::bytes_moved(args...)};
+            return std::get<IN>(self.funcs)(std::forward<Args>(args)...);
+         }
+
+         /// Starts or stops recording call counts, bytes and wall time for every intrinsic, off by default
+         static void enable_stats(bool enable = true) {
+            intrinsics::get().stats_enabled = enable;
+         }
+
+         static void reset_stats() {
+            intrinsics::get().stats = {};
+         }
+
+         static stats_snapshot snapshot_stats() {
+            return intrinsics::get().stats;
+         }
+
+         static const char* name_of(intrinsic_name in) {
+            static constexpr const char* names[] = {
+               INTRINSICS(CREATE_NAME_STRING)
+            };
+            return names[in];
          }
 
          template <intrinsic_name IN, typename F>
@@ -39,6 +127,10 @@ namespace eosio { namespace native {
                -> typename std::remove_reference<decltype(std::get<IN>(intrinsics::get().funcs))>::type {
             return std::get<IN>(intrinsics::get().funcs);
          }
+
+      private:
+         bool           stats_enabled = false;
+         stats_snapshot stats;
    };
 
 }} //ns eosio::native
@@ -11,9 +11,27 @@
 #include <eosio/transaction.h>
 #include <eosio/types.h>
 #include <eosio/security_group.h>
+#include <eosio/map.hpp>
 
 #include <type_traits>
 
+// the kv intrinsics are only declared by map.hpp, bring them to the global scope alongside the C API ones
+using eosio::kv::internal_use_do_not_use::kv_erase;
+using eosio::kv::internal_use_do_not_use::kv_set;
+using eosio::kv::internal_use_do_not_use::kv_get;
+using eosio::kv::internal_use_do_not_use::kv_get_data;
+using eosio::kv::internal_use_do_not_use::kv_it_create;
+using eosio::kv::internal_use_do_not_use::kv_it_destroy;
+using eosio::kv::internal_use_do_not_use::kv_it_status;
+using eosio::kv::internal_use_do_not_use::kv_it_compare;
+using eosio::kv::internal_use_do_not_use::kv_it_key_compare;
+using eosio::kv::internal_use_do_not_use::kv_it_move_to_end;
+using eosio::kv::internal_use_do_not_use::kv_it_next;
+using eosio::kv::internal_use_do_not_use::kv_it_prev;
+using eosio::kv::internal_use_do_not_use::kv_it_lower_bound;
+using eosio::kv::internal_use_do_not_use::kv_it_key;
+using eosio::kv::internal_use_do_not_use::kv_it_value;
+
 namespace eosio { namespace native {
    template <typename... Args, size_t... Is>
    auto get_args_full(std::index_sequence<Is...>) {
@@ -164,17 +182,35 @@ intrinsic_macro(set_action_return_value) \
 intrinsic_macro(add_security_group_participants) \
 intrinsic_macro(remove_security_group_participants) \
 intrinsic_macro(in_active_security_group) \
-intrinsic_macro(get_active_security_group)
+intrinsic_macro(get_active_security_group) \
+intrinsic_macro(kv_erase) \
+intrinsic_macro(kv_set) \
+intrinsic_macro(kv_get) \
+intrinsic_macro(kv_get_data) \
+intrinsic_macro(kv_it_create) \
+intrinsic_macro(kv_it_destroy) \
+intrinsic_macro(kv_it_status) \
+intrinsic_macro(kv_it_compare) \
+intrinsic_macro(kv_it_key_compare) \
+intrinsic_macro(kv_it_move_to_end) \
+intrinsic_macro(kv_it_next) \
+intrinsic_macro(kv_it_prev) \
+intrinsic_macro(kv_it_lower_bound) \
+intrinsic_macro(kv_it_key) \
+intrinsic_macro(kv_it_value)
 
 
 #define CREATE_ENUM(name) \
    name,
 
+#define CREATE_NAME_STRING(name) \
+   #name,
+
 #define GENERATE_TYPE_MAPPING(name) \
    struct __ ## name ## _types { \
       using deduced_full_ts = decltype(eosio::native::get_args_full(::name)); \
       using deduced_ts      = decltype(eosio::native::get_args(::name)); \
-      using res_t           = decltype(std::apply(::name, deduced_ts{})); \
+      using res_t           = decltype(std::apply(::name, std::declval<deduced_ts&>())); \
       static constexpr auto is = std::make_index_sequence<std::tuple_size<deduced_ts>::value>(); \
    };
 
@@ -2,6 +2,7 @@
 #include <eosio/eosio.hpp>
 #include "crt.hpp"
 #include "intrinsics.hpp"
+#include "chain_state.hpp"
 #include <setjmp.h>
 #include <vector>
 
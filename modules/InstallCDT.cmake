@@ -69,6 +69,9 @@ eosio_clang_install(wasm-ld)
 eosio_tool_install_and_symlink(eosio-pp eosio-pp)
 eosio_tool_install_and_symlink(eosio-wast2wasm eosio-wast2wasm)
 eosio_tool_install_and_symlink(eosio-wasm2wast eosio-wasm2wast)
+eosio_tool_install_and_symlink(eosio-wasm-size eosio-wasm-size)
+eosio_tool_install_and_symlink(eosio-wasm-budget eosio-wasm-budget)
+eosio_tool_install_and_symlink(eosio-profile eosio-profile)
 eosio_tool_install_and_symlink(eosio-cc eosio-cc)
 eosio_tool_install_and_symlink(eosio-cpp eosio-cpp)
 eosio_tool_install_and_symlink(eosio-ld eosio-ld)
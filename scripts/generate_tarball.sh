@@ -64,6 +64,9 @@ create_symlink eosio-pp eosio-pp
 create_symlink eosio-init eosio-init
 create_symlink eosio-wasm2wast eosio-wasm2wast
 create_symlink eosio-wast2wasm eosio-wast2wasm
+create_symlink eosio-wasm-size eosio-wasm-size
+create_symlink eosio-wasm-budget eosio-wasm-budget
+create_symlink eosio-profile eosio-profile
 create_symlink eosio-ar eosio-ar
 create_symlink eosio-abidiff eosio-abidiff
 create_symlink eosio-nm eosio-nm
@@ -27,6 +27,22 @@ BOOST_FIXTURE_TEST_CASE( malloc_tests, tester ) try {
 
    push_action("test"_n, "mallocpass"_n, "test"_n, {});
    push_action("test"_n, "mallocalign"_n, "test"_n, {});
+   push_action("test"_n, "mallocfree"_n, "test"_n, {});
+   BOOST_CHECK_EXCEPTION( push_action("test"_n, "mallocfail"_n, "test"_n, {}),
+                          eosio_assert_message_exception,
+                          eosio_assert_message_is("failed to allocate pages") );
+} FC_LOG_AND_RETHROW()
+
+BOOST_FIXTURE_TEST_CASE( size_class_malloc_tests, tester ) try {
+   create_accounts( { "test"_n } );
+   produce_block();
+   set_code( "test"_n, contracts::size_class_malloc_tests_wasm() );
+   set_abi( "test"_n, contracts::size_class_malloc_tests_abi().data() );
+   produce_blocks();
+
+   push_action("test"_n, "mallocpass"_n, "test"_n, {});
+   push_action("test"_n, "mallocalign"_n, "test"_n, {});
+   push_action("test"_n, "mallocfree"_n, "test"_n, {});
    BOOST_CHECK_EXCEPTION( push_action("test"_n, "mallocfail"_n, "test"_n, {}),
                           eosio_assert_message_exception,
                           eosio_assert_message_is("failed to allocate pages") );
@@ -0,0 +1,27 @@
+/*
+ * Verifies that action parameters declared as std::string_view or eosio::bytes_view are
+ * described in the ABI as `string` and `bytes`.
+ */
+
+#include <eosio/eosio.hpp>
+#include <eosio/bytes_view.hpp>
+
+#include <string_view>
+
+using namespace eosio;
+
+class [[eosio::contract]] action_views : public contract {
+public:
+   using contract::contract;
+
+   [[eosio::action]]
+   void memo(name user, std::string_view text) {
+      check(text.size() <= 256, "memo too long");
+      print(user, ": ", text.size());
+   }
+
+   [[eosio::action]]
+   void proof(bytes_view data) {
+      check(!data.empty(), "empty proof");
+   }
+};
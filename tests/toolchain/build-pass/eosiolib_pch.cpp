@@ -0,0 +1,28 @@
+// Contracts starting with #include <eosio/eosio.hpp> are compiled against the precompiled eosiolib header.
+// Building with it in process and without it (-fno-eosiolib-pch) must give the same wasm and abi.
+#include <eosio/eosio.hpp>
+
+using namespace eosio;
+
+class [[eosio::contract]] eosiolib_pch : public contract {
+   public:
+      using contract::contract;
+
+      struct [[eosio::table]] greeting {
+         name     user;
+         uint64_t count;
+         uint64_t primary_key() const { return user.value; }
+      };
+      using greetings = multi_index<"greetings"_n, greeting>;
+
+      [[eosio::action]] void hi(name user) {
+         require_auth(user);
+         greetings table(get_self(), get_self().value);
+         auto itr = table.find(user.value);
+         if (itr == table.end())
+            table.emplace(user, [&](auto& g) { g = greeting{user, 1}; });
+         else
+            table.modify(itr, user, [](auto& g) { ++g.count; });
+         print("hello, ", user);
+      }
+};
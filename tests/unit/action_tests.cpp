@@ -0,0 +1,99 @@
+/**
+ *  @file
+ *  @copyright defined in eosio.cdt/LICENSE.txt
+ */
+
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <eosio/action.hpp>
+#include <eosio/eosio.hpp>
+#include <eosio/tester.hpp>
+
+using std::make_tuple;
+using std::string;
+using std::vector;
+
+using eosio::action;
+using eosio::action_wrapper;
+using eosio::name;
+using eosio::pack;
+using eosio::permission_level;
+using eosio::unsigned_int;
+using eosio::variant_action_wrapper;
+using eosio::native::intrinsics;
+
+struct token {
+   void transfer( name from, name to, uint64_t amount, const string& memo ) {}
+   void notify( name account ) {}
+};
+
+using transfer_action = action_wrapper<"transfer"_n, &token::transfer>;
+using notify_action   = action_wrapper<"notify"_n, &token::notify>;
+using either_action   = variant_action_wrapper<"either"_n, &token::transfer, &token::notify>;
+
+static vector<char> sent;
+static bool         sent_context_free = false;
+
+// Definitions in `eosio.cdt/libraries/eosiolib/contracts/eosio/action.hpp`
+EOSIO_TEST_BEGIN(action_send_test)
+   intrinsics::set_intrinsic<intrinsics::send_inline>([](char* data, size_t size) {
+      sent.assign(data, data + size);
+      sent_context_free = false;
+   });
+   intrinsics::set_intrinsic<intrinsics::send_context_free_inline>([](char* data, size_t size) {
+      sent.assign(data, data + size);
+      sent_context_free = true;
+   });
+
+   const permission_level auth{"alice"_n, "active"_n};
+
+   // the bytes sent are those of the packed action
+   action act{auth, "eosio.token"_n, "transfer"_n, make_tuple("alice"_n, "bob"_n, uint64_t(10), string("memo"))};
+   act.send();
+   CHECK_EQUAL( sent, pack(act) )
+   CHECK_EQUAL( sent_context_free, false )
+
+   // wrappers serialize their arguments straight into the same layout
+   sent.clear();
+   transfer_action{"eosio.token"_n, auth}.send("alice"_n, "bob"_n, uint64_t(10), string("memo"));
+   CHECK_EQUAL( sent, pack(act) )
+
+   // actions past the stack buffer size go through the heap
+   const string memo(2000, 'm');
+   action large{vector<permission_level>{auth, {"bob"_n, "active"_n}}, "eosio.token"_n, "transfer"_n,
+                make_tuple("alice"_n, "bob"_n, uint64_t(10), memo)};
+   large.send();
+   CHECK_EQUAL( sent, pack(large) )
+   sent.clear();
+   transfer_action{"eosio.token"_n, {auth, {"bob"_n, "active"_n}}}.send("alice"_n, "bob"_n, uint64_t(10), memo);
+   CHECK_EQUAL( sent, pack(large) )
+
+   // variant wrappers prefix the data with the variant index
+   either_action{"eosio.token"_n, auth}.send<1>("bob"_n);
+   CHECK_EQUAL( sent, pack(action{auth, "eosio.token"_n, "either"_n, make_tuple(unsigned_int(1), "bob"_n)}) )
+
+   action notify{vector<permission_level>{}, "eosio.token"_n, "notify"_n, make_tuple("bob"_n)};
+   notify.send_context_free();
+   CHECK_EQUAL( sent, pack(notify) )
+   CHECK_EQUAL( sent_context_free, true )
+   sent.clear();
+   notify_action{"eosio.token"_n, vector<permission_level>{}}.send_context_free("bob"_n);
+   CHECK_EQUAL( sent, pack(notify) )
+
+   CHECK_ASSERT( "context free actions cannot have authorizations", [&]() {
+      notify_action{"eosio.token"_n, auth}.send_context_free("bob"_n);
+   } )
+EOSIO_TEST_END
+
+int main(int argc, char* argv[]) {
+   bool verbose = false;
+   if( argc >= 2 && std::strcmp( argv[1], "-v" ) == 0 ) {
+      verbose = true;
+   }
+   silence_output(!verbose);
+
+   EOSIO_TEST(action_send_test)
+   return has_failed();
+}
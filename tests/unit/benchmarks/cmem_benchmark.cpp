@@ -0,0 +1,110 @@
+/**
+ *  @file
+ *  @copyright defined in eosio.cdt/LICENSE.txt
+ *
+ *  Compares the word-at-a-time eosio_cmem primitives against the byte loops they replaced.
+ *  Timings are reported in cycles per call for a set of sizes and alignments; correctness is covered by
+ *  tests/unit/memory_tests.cpp.
+ */
+
+#include <eosio/eosio.hpp>
+#include <eosio/tester.hpp>
+#include <eosiolib/memory.hpp>
+
+#include <cstdio>
+#include <cstring>
+
+using namespace eosio::native;
+
+namespace legacy {
+   void* memset( void* ptr, int c, size_t n ) {
+      uint8_t* p = (uint8_t*)ptr;
+      for ( size_t i=0; i < n; i++ )
+         p[i] = (uint8_t)c;
+      return ptr;
+   }
+   void* memcpy( void* ptr1, const void* ptr2, size_t n ) {
+      uint8_t* p1 = (uint8_t*)ptr1;
+      const uint8_t* p2 = (const uint8_t*)ptr2;
+      for ( size_t i=0; i < n; i++ )
+         p1[i] = p2[i];
+      return ptr1;
+   }
+   void* memmove( void* ptr1, const void* ptr2, size_t n ) {
+      uint8_t* p1 = (uint8_t*)ptr1;
+      const uint8_t* p2 = (const uint8_t*)ptr2;
+      uint8_t* p3 = new uint8_t[n];
+      memcpy( p3, p2, n );
+      memcpy( p1, p3, n );
+      delete[] p3;
+      return ptr1;
+   }
+   int memcmp( const void* ptr1, const void* ptr2, size_t n ) {
+      const uint8_t* p1 = (uint8_t*)ptr1;
+      const uint8_t* p2 = (uint8_t*)ptr2;
+      for ( size_t i=0; i < n; i++ ) {
+         if ( p1[i] < p2[i] )
+            return -1;
+         else if ( p1[i] > p2[i] )
+            return 1;
+      }
+      return 0;
+   }
+} // ns legacy
+
+static constexpr size_t buffer_size = 8192;
+static uint8_t src_buf[buffer_size + 64];
+static uint8_t dst_buf[buffer_size + 64];
+static uint8_t ref_buf[buffer_size + 64];
+
+static void scramble(uint8_t* buf, size_t n, uint32_t seed) {
+   for (size_t i = 0; i < n; ++i) {
+      seed = seed * 1103515245 + 12345;
+      buf[i] = uint8_t(seed >> 16);
+   }
+}
+
+static constexpr size_t bench_sizes[] = {8, 32, 128, 512, 2048, 8000};
+static constexpr size_t bench_offs[]  = {0, 3};
+
+template <typename F>
+static uint64_t cycles_per_call(size_t iterations, F&& f) {
+   const uint64_t start = __builtin_readcyclecounter();
+   for (size_t i = 0; i < iterations; ++i)
+      f();
+   return (__builtin_readcyclecounter() - start) / iterations;
+}
+
+static volatile int sink;
+
+static void run_benchmarks() {
+   printf("%-8s %-6s %12s %12s %12s %12s %12s %12s %12s %12s\n", "size", "align",
+          "memcpy", "(legacy)", "memmove", "(legacy)", "memset", "(legacy)", "memcmp", "(legacy)");
+   for (size_t n : bench_sizes) {
+      for (size_t off : bench_offs) {
+         const size_t iters = 200000 / (n / 8 + 1) + 100;
+         scramble(src_buf, sizeof(src_buf), uint32_t(n));
+         std::memcpy(ref_buf, src_buf, sizeof(src_buf));
+         printf("%-8zu %-6zu %12llu %12llu %12llu %12llu %12llu %12llu %12llu %12llu\n", n, off,
+                (unsigned long long)cycles_per_call(iters, [&]{ eosio::cmem::copy(dst_buf + off, src_buf, n); }),
+                (unsigned long long)cycles_per_call(iters, [&]{ legacy::memcpy(dst_buf + off, src_buf, n); }),
+                (unsigned long long)cycles_per_call(iters, [&]{ eosio::cmem::move(dst_buf + off, dst_buf + 5, n); }),
+                (unsigned long long)cycles_per_call(iters, [&]{ legacy::memmove(dst_buf + off, dst_buf + 5, n); }),
+                (unsigned long long)cycles_per_call(iters, [&]{ eosio::cmem::fill(dst_buf + off, 0x5a, n); }),
+                (unsigned long long)cycles_per_call(iters, [&]{ legacy::memset(dst_buf + off, 0x5a, n); }),
+                (unsigned long long)cycles_per_call(iters, [&]{ sink = eosio::cmem::compare(src_buf + off, ref_buf + off, n); }),
+                (unsigned long long)cycles_per_call(iters, [&]{ sink = legacy::memcmp(src_buf + off, ref_buf + off, n); }));
+      }
+   }
+}
+
+int main(int argc, char** argv) {
+   bool verbose = false;
+   if( argc >= 2 && std::strcmp( argv[1], "-v" ) == 0 ) {
+      verbose = true;
+   }
+   silence_output(!verbose);
+
+   run_benchmarks();
+   return 0;
+}
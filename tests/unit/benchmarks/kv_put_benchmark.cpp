@@ -0,0 +1,133 @@
+/**
+ *  @file
+ *  @copyright defined in eosio.cdt/LICENSE.txt
+ *
+ *  Counts the KV host calls made per `kv::table::put` for a table without secondary indices and for one with two,
+ *  across inserts, updates that move secondary keys, updates that leave them alone and rewrites of identical rows.
+ *  The KV intrinsics are backed by the native chain state emulator so the contract code runs unmodified.  The
+ *  expected counts are checked by chain_state_kv_put_test in tests/unit/chain_state_tests.cpp.
+ */
+
+#include <eosio/eosio.hpp>
+#include <eosio/table.hpp>
+#include <eosio/tester.hpp>
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+using namespace eosio::native;
+using namespace eosio;
+
+namespace {
+   struct kv_host_calls {
+      uint64_t get      = 0;
+      uint64_t get_data = 0;
+      uint64_t set      = 0;
+      uint64_t erase    = 0;
+
+      uint64_t total() const { return get + get_data + set + erase; }
+   };
+} // ns anonymous
+
+class kv_put_benchmark {
+public:
+   struct row {
+      uint64_t    id;
+      std::string owner;
+      uint64_t    balance;
+      std::string memo;
+   };
+
+   struct plain_table : kv::table<row, "plain"_n> {
+      KV_NAMED_INDEX("id"_n, id)
+
+      plain_table(name contract_name) {
+         init(contract_name, id);
+      }
+   };
+
+   struct indexed_table : kv::table<row, "indexed"_n> {
+      KV_NAMED_INDEX("id"_n, id)
+      KV_NAMED_INDEX("owner"_n, owner)
+      KV_NAMED_INDEX("balance"_n, balance)
+
+      indexed_table(name contract_name) {
+         init(contract_name, id, owner, balance);
+      }
+   };
+
+   static row make_row(uint64_t i, uint64_t generation) {
+      return row{i, "owner" + std::to_string(i), i * 10, "memo" + std::to_string(generation)};
+   }
+
+   template <typename Table>
+   static void insert(Table& t, uint64_t n) {
+      for (uint64_t i = 0; i < n; ++i)
+         t.put(make_row(i, 0), self);
+   }
+
+   // only the memo changes, secondary keys stay where they are
+   template <typename Table>
+   static void touch(Table& t, uint64_t n) {
+      for (uint64_t i = 0; i < n; ++i)
+         t.put(make_row(i, 1), self);
+   }
+
+   // every secondary key moves
+   template <typename Table>
+   static void rekey(Table& t, uint64_t n) {
+      for (uint64_t i = 0; i < n; ++i) {
+         auto r = make_row(i, 1);
+         r.owner += "x";
+         r.balance += 1;
+         t.put(r, self);
+      }
+   }
+
+   static constexpr name self = "bench"_n;
+};
+
+static constexpr uint64_t rows = 1000;
+
+template <typename F>
+static kv_host_calls measure(F&& f) {
+   const auto before = intrinsics::snapshot_stats();
+   f();
+   const auto calls = intrinsics::snapshot_stats() - before;
+   return {calls[intrinsics::kv_get].calls, calls[intrinsics::kv_get_data].calls,
+           calls[intrinsics::kv_set].calls, calls[intrinsics::kv_erase].calls};
+}
+
+static void report(const char* table, const char* op, const kv_host_calls& c) {
+   printf("%-8s %-8s %10.2f %10.2f %10.2f %10.2f %10.2f\n", table, op,
+          double(c.get) / rows, double(c.get_data) / rows, double(c.set) / rows, double(c.erase) / rows,
+          double(c.total()) / rows);
+}
+
+static void run_benchmarks() {
+   chain_state::reset();
+   kv_put_benchmark::plain_table plain{kv_put_benchmark::self};
+   kv_put_benchmark::indexed_table indexed{kv_put_benchmark::self};
+
+   printf("%-8s %-8s %10s %10s %10s %10s %10s\n", "table", "op", "kv_get", "get_data", "kv_set", "kv_erase", "total");
+   report("plain", "insert", measure([&]{ kv_put_benchmark::insert(plain, rows); }));
+   report("plain", "update", measure([&]{ kv_put_benchmark::touch(plain, rows); }));
+   report("indexed", "insert", measure([&]{ kv_put_benchmark::insert(indexed, rows); }));
+   report("indexed", "update", measure([&]{ kv_put_benchmark::touch(indexed, rows); }));
+   report("indexed", "rekey", measure([&]{ kv_put_benchmark::rekey(indexed, rows); }));
+   report("indexed", "rewrite", measure([&]{ kv_put_benchmark::rekey(indexed, rows); }));
+}
+
+int main(int argc, char** argv) {
+   bool verbose = false;
+   if( argc >= 2 && std::strcmp( argv[1], "-v" ) == 0 ) {
+      verbose = true;
+   }
+   silence_output(!verbose);
+   chain_state::install(kv_put_benchmark::self);
+   intrinsics::enable_stats();
+
+   run_benchmarks();
+   return 0;
+}
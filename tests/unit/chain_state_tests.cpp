@@ -0,0 +1,605 @@
+/**
+ *  @file
+ *  @copyright defined in eosio.cdt/LICENSE.txt
+ */
+
+// the unit tests are built as Release, keep the debug-only checks of multi_index::modify_fields
+#undef NDEBUG
+
+#include <string>
+#include <vector>
+
+#include <eosio/eosio.hpp>
+#include <eosio/map.hpp>
+#include <eosio/multi_index.hpp>
+#include <eosio/table.hpp>
+#include <eosio/tester.hpp>
+
+using std::string;
+using std::vector;
+
+using eosio::indexed_by;
+using eosio::const_mem_fun;
+using eosio::multi_index;
+using eosio::name;
+using eosio::native::chain_state;
+using eosio::native::intrinsics;
+
+static constexpr name self  = "chainstate"_n;
+static constexpr name other = "other"_n;
+
+struct account {
+   uint64_t id;
+   uint64_t balance;
+   double   weight;
+   string   owner;
+
+   uint64_t primary_key() const { return id; }
+   uint64_t by_balance() const { return balance; }
+   double   by_weight() const { return weight; }
+
+   EOSLIB_SERIALIZE( account, (id)(balance)(weight)(owner) )
+};
+
+using accounts = multi_index<"accounts"_n, account,
+   indexed_by<"balance"_n, const_mem_fun<account, uint64_t, &account::by_balance>>,
+   indexed_by<"weight"_n, const_mem_fun<account, double, &account::by_weight>>
+>;
+
+using member_accounts = multi_index<"maccounts"_n, account,
+   indexed_by<"balance"_n, eosio::member<account, uint64_t, &account::balance>>,
+   indexed_by<"weight"_n, eosio::member<account, double, &account::weight>>
+>;
+
+using lru_accounts = multi_index<"accounts"_n, account,
+   indexed_by<"balance"_n, const_mem_fun<account, uint64_t, &account::by_balance>>,
+   eosio::lru_cache<2>
+>;
+
+struct kv_account {
+   uint64_t id;
+   string   owner;
+};
+
+struct kv_accounts : eosio::kv::table<kv_account, "kvaccounts"_n> {
+   KV_NAMED_INDEX("id"_n, id)
+   KV_NAMED_INDEX("owner"_n, owner)
+
+   kv_accounts(name contract_name) {
+      init(contract_name, id, owner);
+   }
+};
+
+struct kv_ledger_row {
+   uint64_t id;
+   string   owner;
+   uint64_t balance;
+   string   memo;
+};
+
+struct kv_plain_ledger : eosio::kv::table<kv_ledger_row, "kvplain"_n> {
+   KV_NAMED_INDEX("id"_n, id)
+
+   kv_plain_ledger(name contract_name) {
+      init(contract_name, id);
+   }
+};
+
+struct kv_ledger : eosio::kv::table<kv_ledger_row, "kvledger"_n> {
+   KV_NAMED_INDEX("id"_n, id)
+   KV_NAMED_INDEX("owner"_n, owner)
+   KV_NAMED_INDEX("balance"_n, balance)
+
+   kv_ledger(name contract_name) {
+      init(contract_name, id, owner, balance);
+   }
+};
+
+// Definitions in `eosio.cdt/libraries/native/chain_state.cpp`
+EOSIO_TEST_BEGIN(chain_state_multi_index_test)
+   chain_state::install(self);
+   chain_state::reset();
+
+   accounts t{self, self.value};
+   for (uint64_t i = 1; i <= 5; ++i)
+      t.emplace(self, [&](auto& a) { a = account{i, 100 * (6 - i), 0.5 * i, "owner" + std::to_string(i)}; });
+
+   CHECK_EQUAL( chain_state::row_count(self, self.value, "accounts"_n), 5u )
+   CHECK_EQUAL( t.get(3).owner, string("owner3") )
+   CHECK_EQUAL( t.find(6) == t.end(), true )
+   CHECK_EQUAL( t.lower_bound(4)->id, 4ull )
+   CHECK_EQUAL( t.upper_bound(4)->id, 5ull )
+   CHECK_EQUAL( (--t.end())->id, 5ull )
+
+   vector<uint64_t> ids;
+   for (const auto& a : t)
+      ids.push_back(a.id);
+   CHECK_EQUAL( ids, (vector<uint64_t>{1, 2, 3, 4, 5}) )
+
+   // secondary indices iterate in key order and follow modifications
+   auto by_balance = t.get_index<"balance"_n>();
+   ids.clear();
+   for (const auto& a : by_balance)
+      ids.push_back(a.id);
+   CHECK_EQUAL( ids, (vector<uint64_t>{5, 4, 3, 2, 1}) )
+
+   t.modify(t.find(5), self, [](auto& a) { a.balance = 1000; a.weight = 0.1; });
+   CHECK_EQUAL( (--by_balance.end())->id, 5ull )
+   CHECK_EQUAL( by_balance.lower_bound(300)->id, 3ull )
+   CHECK_EQUAL( by_balance.find(1000)->id, 5ull )
+   CHECK_EQUAL( t.get_index<"weight"_n>().begin()->id, 5ull )
+
+   t.erase(t.find(3));
+   CHECK_EQUAL( chain_state::row_count(self, self.value, "accounts"_n), 4u )
+   CHECK_EQUAL( by_balance.find(300) == by_balance.end(), true )
+
+   // other contracts may read the table but not write to it
+   chain_state::set_receiver(other);
+   accounts foreign{self, self.value};
+   CHECK_EQUAL( foreign.get(4).owner, string("owner4") )
+   CHECK_ASSERT( "cannot erase objects in table of another contract", [&]() { foreign.erase(foreign.find(4)); } )
+   CHECK_ASSERT( "db access violation", []() {
+      db_remove_i64(db_find_i64(self.value, self.value, "accounts"_n.value, 4));
+   } )
+   chain_state::set_receiver(self);
+
+   chain_state::reset();
+   CHECK_EQUAL( chain_state::row_count(self, self.value, "accounts"_n), 0u )
+   accounts empty{self, self.value};
+   CHECK_EQUAL( empty.begin() == empty.end(), true )
+EOSIO_TEST_END
+
+EOSIO_TEST_BEGIN(chain_state_key_iterator_test)
+   chain_state::install(self);
+   chain_state::reset();
+
+   accounts t{self, self.value};
+   for (uint64_t i = 1; i <= 5; ++i)
+      t.emplace(self, [&](auto& a) { a = account{i, 100 * (6 - i), 0.5 * i, "owner" + std::to_string(i)}; });
+
+   // a fresh table object has nothing cached, so every row read shows up as a db_get_i64
+   accounts fresh{self, self.value};
+   auto by_balance = fresh.get_index<"balance"_n>();
+   intrinsics::reset_stats();
+   intrinsics::enable_stats();
+
+   vector<uint64_t> ids;
+   vector<uint64_t> balances;
+   for (auto itr = by_balance.key_begin(); itr != by_balance.key_end(); ++itr) {
+      ids.push_back(itr.primary_key());
+      balances.push_back(itr.secondary_key());
+   }
+   CHECK_EQUAL( ids, (vector<uint64_t>{5, 4, 3, 2, 1}) )
+   CHECK_EQUAL( balances, (vector<uint64_t>{100, 200, 300, 400, 500}) )
+   CHECK_EQUAL( intrinsics::snapshot_stats()[intrinsics::db_get_i64].calls, 0ull )
+
+   auto itr = by_balance.key_lower_bound(250);
+   CHECK_EQUAL( itr.primary_key(), 3ull )
+   CHECK_EQUAL( itr.secondary_key(), 300ull )
+   CHECK_EQUAL( by_balance.key_upper_bound(300).primary_key(), 2ull )
+   CHECK_EQUAL( by_balance.key_lower_bound(600) == by_balance.key_end(), true )
+   CHECK_EQUAL( (--by_balance.key_end()).primary_key(), 1ull )
+   CHECK_EQUAL( intrinsics::snapshot_stats()[intrinsics::db_get_i64].calls, 0ull )
+
+   // dereferencing loads the row, which can then go to modify and erase
+   CHECK_EQUAL( itr->owner, string("owner3") )
+   CHECK_EQUAL( intrinsics::snapshot_stats()[intrinsics::db_get_i64].calls > 0, true )
+   by_balance.modify(by_balance.iterator_to(*itr), self, [](auto& a) { a.balance = 50; });
+   CHECK_EQUAL( by_balance.key_begin().primary_key(), 3ull )
+   CHECK_EQUAL( by_balance.key_begin().secondary_key(), 50ull )
+   intrinsics::enable_stats(false);
+
+   CHECK_ASSERT( "cannot increment end iterator", [&]() { ++by_balance.key_end(); } )
+   CHECK_ASSERT( "cannot read the key of an end iterator", [&]() { by_balance.key_end().primary_key(); } )
+
+   chain_state::reset();
+   accounts empty{self, self.value};
+   auto empty_index = empty.get_index<"balance"_n>();
+   CHECK_EQUAL( empty_index.key_begin() == empty_index.key_end(), true )
+   CHECK_ASSERT( "cannot decrement end iterator when the index is empty", [&]() { --empty_index.key_end(); } )
+EOSIO_TEST_END
+
+EOSIO_TEST_BEGIN(chain_state_modify_fields_test)
+   chain_state::install(self);
+   chain_state::reset();
+
+   member_accounts t{self, self.value};
+   for (uint64_t i = 1; i <= 5; ++i)
+      t.emplace(self, [&](auto& a) { a = account{i, 100 * (6 - i), 0.5 * i, "owner" + std::to_string(i)}; });
+
+   // a fresh table object has no index iterators cached, so each index updated needs a find_primary. As with
+   // modify, an index whose key did not change costs no host calls.
+   member_accounts fresh{self, self.value};
+   auto stats = []() { return intrinsics::snapshot_stats(); };
+   intrinsics::reset_stats();
+   intrinsics::enable_stats();
+
+   // only the balance index depends on balance
+   fresh.modify_fields<&account::balance>(fresh.find(2), self, [](auto& a) { a.balance = 1000; });
+   CHECK_EQUAL( stats()[intrinsics::db_idx64_find_primary].calls, 1ull )
+   CHECK_EQUAL( stats()[intrinsics::db_idx64_update].calls, 1ull )
+   CHECK_EQUAL( stats()[intrinsics::db_idx_double_find_primary].calls, 0ull )
+   CHECK_EQUAL( stats()[intrinsics::db_idx_double_update].calls, 0ull )
+
+   // neither index depends on owner
+   intrinsics::reset_stats();
+   fresh.modify_fields<&account::owner>(fresh.find(3), self, [](auto& a) { a.owner = "renamed"; });
+   CHECK_EQUAL( stats()[intrinsics::db_update_i64].calls, 1ull )
+   CHECK_EQUAL( stats()[intrinsics::db_idx64_find_primary].calls, 0ull )
+   CHECK_EQUAL( stats()[intrinsics::db_idx_double_find_primary].calls, 0ull )
+
+   // a listed member that keeps its value leaves its index alone as well
+   intrinsics::reset_stats();
+   fresh.modify_fields<&account::balance, &account::weight>(fresh.find(4), self, [](auto& a) { a.weight = 9.5; });
+   CHECK_EQUAL( stats()[intrinsics::db_idx64_update].calls, 0ull )
+   CHECK_EQUAL( stats()[intrinsics::db_idx_double_update].calls, 1ull )
+   intrinsics::enable_stats(false);
+
+   CHECK_EQUAL( (--fresh.get_index<"balance"_n>().end())->id, 2ull )
+   CHECK_EQUAL( fresh.get_index<"weight"_n>().find(9.5)->id, 4ull )
+   CHECK_EQUAL( member_accounts(self, self.value).get(3).owner, string("renamed") )
+
+   CHECK_ASSERT( "cannot pass end iterator to modify", [&]() {
+      fresh.modify_fields<&account::owner>(fresh.end(), self, [](auto&) {});
+   } )
+   CHECK_ASSERT( "updater cannot change primary key when modifying an object", [&]() {
+      fresh.modify_fields<&account::id>(fresh.find(5), self, [](auto& a) { a.id = 6; });
+   } )
+
+   // modify picks up a change to any member
+   fresh.modify(fresh.find(1), self, [](auto& a) { a.balance = 7; });
+   CHECK_EQUAL( fresh.get_index<"balance"_n>().find(7)->id, 1ull )
+
+   // modify_fields does not look at the balance index unless told about balance, which would leave it stale
+   CHECK_ASSERT( "updater changed a data member not passed to modify_fields", [&]() {
+      fresh.modify_fields<&account::owner>(fresh.find(1), self, [](auto& a) { a.owner = "other"; a.balance = 8; });
+   } )
+EOSIO_TEST_END
+
+EOSIO_TEST_BEGIN(chain_state_emplace_many_test)
+   chain_state::install(self);
+   chain_state::reset();
+
+   accounts t{self, self.value};
+   vector<account> rows;
+   for (uint64_t i = 1; i <= 3; ++i)
+      rows.push_back(account{i, 100 * i, 0.5 * i, "owner" + std::to_string(i)});
+   t.emplace_many(self, rows);
+   t.emplace_many(self, 2, [](auto& a, size_t i) { a = account{10 + i, 50 + i, 0.1, "generated"}; });
+
+   CHECK_EQUAL( chain_state::row_count(self, self.value, "accounts"_n), 5u )
+   CHECK_EQUAL( t.available_primary_key(), 12ull )
+   CHECK_EQUAL( t.get_index<"balance"_n>().begin()->id, 10ull )
+   CHECK_EQUAL( t.get_index<"weight"_n>().find(1.5)->id, 3ull )
+
+   // emplaced rows are not cached, the first lookup reads them back
+   intrinsics::reset_stats();
+   intrinsics::enable_stats();
+   CHECK_EQUAL( t.get(2).owner, string("owner2") )
+   CHECK_EQUAL( intrinsics::snapshot_stats()[intrinsics::db_get_i64].calls > 0, true )
+
+   // once cached, lookups stay out of the database until the cache is cleared
+   intrinsics::reset_stats();
+   CHECK_EQUAL( t.get(2).owner, string("owner2") )
+   CHECK_EQUAL( intrinsics::snapshot_stats()[intrinsics::db_get_i64].calls, 0ull )
+   t.clear_cache();
+   CHECK_EQUAL( t.get(2).owner, string("owner2") )
+   CHECK_EQUAL( intrinsics::snapshot_stats()[intrinsics::db_get_i64].calls > 0, true )
+   intrinsics::enable_stats(false);
+
+   t.erase(t.find(2));
+   CHECK_EQUAL( t.find(2) == t.end(), true )
+   CHECK_EQUAL( chain_state::row_count(self, self.value, "accounts"_n), 4u )
+
+   chain_state::set_receiver(other);
+   accounts foreign{self, self.value};
+   CHECK_ASSERT( "cannot create objects in table of another contract", [&]() { foreign.emplace_many(self, rows); } )
+   chain_state::set_receiver(self);
+EOSIO_TEST_END
+
+EOSIO_TEST_BEGIN(chain_state_lru_cache_test)
+   chain_state::install(self);
+   chain_state::reset();
+
+   lru_accounts t{self, self.value};
+   for (uint64_t i = 1; i <= 5; ++i)
+      t.emplace(self, [&](auto& a) { a = account{i, 100 * (6 - i), 0.5 * i, "owner" + std::to_string(i)}; });
+
+   // whether running `f` reads any row from the database
+   auto loads = [](auto&& f) {
+      intrinsics::reset_stats();
+      intrinsics::enable_stats();
+      f();
+      intrinsics::enable_stats(false);
+      return intrinsics::snapshot_stats()[intrinsics::db_get_i64].calls > 0;
+   };
+
+   // only the two most recently used rows are kept
+   CHECK_EQUAL( loads([&]() { t.get(4); t.get(5); }), false )
+   CHECK_EQUAL( loads([&]() { t.get(1); }), true )
+   CHECK_EQUAL( loads([&]() { t.get(5); }), false )
+   CHECK_EQUAL( loads([&]() { t.get(4); }), true )
+
+   // rows iterators point to stay cached however many rows are loaded
+   auto pinned = t.find(2);
+   vector<uint64_t> ids;
+   for (const auto& a : t)
+      ids.push_back(a.id);
+   CHECK_EQUAL( ids, (vector<uint64_t>{1, 2, 3, 4, 5}) )
+   CHECK_EQUAL( pinned->owner, string("owner2") )
+   CHECK_EQUAL( loads([&]() { t.get(2); }), false )
+
+   auto by_balance = t.get_index<"balance"_n>();
+   ids.clear();
+   for (const auto& a : by_balance)
+      ids.push_back(a.id);
+   CHECK_EQUAL( ids, (vector<uint64_t>{5, 4, 3, 2, 1}) )
+
+   // an erased row stays valid for the iterators still pointing to it
+   auto copy = pinned;
+   auto next = t.erase(pinned);
+   CHECK_EQUAL( next->id, 3ull )
+   CHECK_EQUAL( copy->owner, string("owner2") )
+   copy = next;
+   CHECK_EQUAL( t.find(2) == t.end(), true )
+   CHECK_EQUAL( chain_state::row_count(self, self.value, "accounts"_n), 4u )
+
+   t.clear_cache();
+   CHECK_EQUAL( next->owner, string("owner3") )
+   CHECK_EQUAL( loads([&]() { t.get(3); }), false )
+EOSIO_TEST_END
+
+EOSIO_TEST_BEGIN(chain_state_kv_table_test)
+   chain_state::install(self);
+   chain_state::reset();
+
+   kv_accounts t{self};
+   t.put({1, "carol"}, self);
+   t.put({2, "alice"}, self);
+   t.put({3, "bob"}, self);
+   CHECK_EQUAL( chain_state::kv_size(self), 6u )
+
+   CHECK_EQUAL( t.id.get(2)->owner, string("alice") )
+   CHECK_EQUAL( t.owner.get("bob")->id, 3ull )
+   CHECK_EQUAL( t.owner.exists("dave"), false )
+
+   vector<uint64_t> ids;
+   for (auto it = t.owner.begin(); it != t.owner.end(); ++it)
+      ids.push_back(it.value().id);
+   CHECK_EQUAL( ids, (vector<uint64_t>{2, 3, 1}) )
+
+   ids.clear();
+   for (auto it = t.id.rbegin(); it != t.id.rend(); ++it)
+      ids.push_back(it.value().id);
+   CHECK_EQUAL( ids, (vector<uint64_t>{3, 2, 1}) )
+
+   CHECK_EQUAL( t.owner.lower_bound("b").value().id, 3ull )
+   CHECK_EQUAL( t.owner.upper_bound("bob").value().id, 1ull )
+
+   t.erase({3, "bob"});
+   CHECK_EQUAL( chain_state::kv_size(self), 4u )
+   CHECK_EQUAL( t.owner.get("bob").has_value(), false )
+
+   chain_state::set_receiver(other);
+   CHECK_ASSERT( "Can not write to this key", [&]() { t.put({4, "erin"}, self); } )
+   chain_state::set_receiver(self);
+EOSIO_TEST_END
+
+EOSIO_TEST_BEGIN(chain_state_kv_put_test)
+   chain_state::install(self);
+   chain_state::reset();
+
+   // the KV host calls made while running `f`
+   struct kv_calls { uint64_t get, get_data, set, erase; uint64_t total() const { return get + get_data + set + erase; } };
+   auto calls = [](auto&& f) {
+      intrinsics::reset_stats();
+      intrinsics::enable_stats();
+      f();
+      intrinsics::enable_stats(false);
+      auto stats = intrinsics::snapshot_stats();
+      return kv_calls{stats[intrinsics::kv_get].calls, stats[intrinsics::kv_get_data].calls,
+                      stats[intrinsics::kv_set].calls, stats[intrinsics::kv_erase].calls};
+   };
+   auto row = [](uint64_t i, string memo) { return kv_ledger_row{i, "owner" + std::to_string(i), 10 * i, memo}; };
+
+   // without secondary indices a put is a single kv_set, whether it inserts or updates
+   kv_plain_ledger plain{self};
+   CHECK_EQUAL( calls([&]() { plain.put(row(1, "a"), self); }).total(), 1ull )
+   CHECK_EQUAL( calls([&]() { plain.put(row(1, "b"), self); }).total(), 1ull )
+   CHECK_EQUAL( plain.id.get(1)->memo, string("b") )
+
+   kv_ledger t{self};
+   for (uint64_t i = 1; i <= 3; ++i) {
+      auto c = calls([&]() { t.put(row(i, "a"), self); });
+      CHECK_EQUAL( c.get, 3ull )
+      CHECK_EQUAL( c.set, 3ull )
+   }
+
+   // secondary keys unchanged: the old row is read and the new one written, nothing per index
+   CHECK_EQUAL( calls([&]() { t.put(row(2, "b"), self); }).total(), 3ull )
+   CHECK_EQUAL( t.id.get(2)->memo, string("b") )
+
+   // every secondary key moves
+   auto moved = row(2, "b");
+   moved.owner   = "moved";
+   moved.balance = 25;
+   CHECK_EQUAL( calls([&]() { t.put(moved, self); }).erase, 2ull )
+   CHECK_EQUAL( t.owner.get("moved")->id, 2ull )
+   CHECK_EQUAL( t.owner.exists("owner2"), false )
+   CHECK_EQUAL( t.balance.get(25)->id, 2ull )
+   CHECK_EQUAL( t.balance.exists(20), false )
+
+   // a byte-identical rewrite skips the secondary indices altogether
+   CHECK_EQUAL( calls([&]() { t.put(moved, self); }).total(), 3ull )
+
+   // moving a secondary key onto another row's key still aborts
+   auto clash = row(1, "a");
+   clash.owner = "owner3";
+   CHECK_ASSERT( "Attempted to update an existing secondary index.", [&]() { t.put(clash, self); } )
+   CHECK_ASSERT( "Attempted to store an existing secondary index.", [&]() { t.put(kv_ledger_row{4, "owner3", 40, ""}, self); } )
+EOSIO_TEST_END
+
+EOSIO_TEST_BEGIN(chain_state_kv_map_test)
+   chain_state::install(self);
+   chain_state::reset();
+
+   eosio::kv::map<"balances"_n, string, uint64_t> m{self};
+   m["carol"] = 30;
+   m["alice"] = 10;
+   m["bob"]   = 20;
+
+   CHECK_EQUAL( m.find("bob")->second(), 20ull )
+   CHECK_EQUAL( m.find("dave") == m.end(), true )
+
+   // iteration follows key order
+   vector<uint64_t> values;
+   for (const auto& e : m)
+      values.push_back(e.second());
+   CHECK_EQUAL( values, (vector<uint64_t>{10, 20, 30}) )
+   CHECK_EQUAL( m.rbegin()->second(), 30ull )
+
+   m.erase("bob");
+   CHECK_EQUAL( m.lower_bound("b")->second(), 30ull )
+   CHECK_EQUAL( chain_state::kv_size(self), 2u )
+
+   // ranged_view produces the elements with keys in [l, h), up to `limit` of them
+   m["bob"]  = 20;
+   m["dave"] = 40;
+   m["erin"] = 50;
+   auto view_values = [](auto&& view) {
+      vector<uint64_t> ret;
+      for (const auto& e : view)
+         ret.push_back(e.second());
+      return ret;
+   };
+   CHECK_EQUAL( view_values(m.ranged_view("bob", "erin")), (vector<uint64_t>{20, 30, 40}) )
+   CHECK_EQUAL( view_values(m.ranged_view("b", "zed")), (vector<uint64_t>{20, 30, 40, 50}) )
+   CHECK_EQUAL( view_values(m.ranged_view("alice", "zed", 2)), (vector<uint64_t>{10, 20}) )
+   CHECK_EQUAL( m.ranged_view("alice", "zed", 0).empty(), true )
+
+   // empty ranges, between two keys, past the last key and with l == h even though that key exists
+   CHECK_EQUAL( m.ranged_view("bz", "c").empty(), true )
+   CHECK_EQUAL( m.ranged_view("f", "zed").empty(), true )
+   {
+      auto same = m.ranged_view("carol", "carol");
+      CHECK_EQUAL( same.empty(), true )
+      CHECK_EQUAL( same.begin() == same.end(), true )
+   }
+
+   // nothing is read before an element is reached
+   intrinsics::reset_stats();
+   intrinsics::enable_stats();
+   {
+      auto lazy = m.ranged_view("alice", "zed");
+      CHECK_EQUAL( lazy.empty(), false )
+      CHECK_EQUAL( intrinsics::snapshot_stats()[intrinsics::kv_it_value].calls, 0ull )
+   }
+   intrinsics::enable_stats(false);
+
+   // ranged_slice collects the same elements as walking from lower_bound(l) to lower_bound(h)
+   vector<decltype(m)::elem_t> walked;
+   for (auto itr = m.lower_bound("bob"); itr != m.lower_bound("erin"); ++itr)
+      walked.push_back(*itr);
+   CHECK_EQUAL( m.ranged_slice("bob", "erin") == walked, true )
+   CHECK_EQUAL( walked.size(), 3u )
+
+   chain_state::reset();
+   CHECK_EQUAL( m.empty(), true )
+EOSIO_TEST_END
+
+// eosio-profile keeps a copy of this chain state; tests/unit/profile_tests.sh runs the same calls through it and
+// expects the same values
+EOSIO_TEST_BEGIN(chain_state_profile_test)
+   namespace db = eosio::internal_use_do_not_use;
+   namespace kv = eosio::kv::internal_use_do_not_use;
+   chain_state::install("prof"_n);
+   chain_state::reset();
+
+   const uint64_t prof = "prof"_n.value, rows = "rows"_n.value;
+   vector<int32_t> r;
+   uint64_t pk = 0, sec = 0;
+   uint32_t ks = 0, vs = 0;
+
+   const int32_t a = db::db_store_i64(prof, rows, prof, 5, "aa", 2);
+   const int32_t b = db::db_store_i64(prof, rows, prof, 9, "bb", 2);
+   const int32_t end = db::db_end_i64(prof, prof, rows);
+   r.insert(r.end(), {a, b, end});
+   r.push_back(db::db_find_i64(prof, prof, rows, 9));
+   r.push_back(db::db_find_i64(prof, prof, rows, 7));
+   r.push_back(db::db_lowerbound_i64(prof, prof, rows, 6));
+   r.push_back(db::db_upperbound_i64(prof, prof, rows, 9));
+   r.push_back(db::db_next_i64(a, &pk));
+   r.push_back(pk);
+   pk = 0;
+   r.push_back(db::db_previous_i64(end, &pk));
+   r.push_back(pk);
+   db::db_update_i64(a, prof, "ccc", 3);
+   db::db_remove_i64(b);
+   r.push_back(db::db_next_i64(a, &pk));
+   r.push_back(db::db_end_i64(prof, prof, "other"_n.value));
+   r.push_back(db::db_find_i64(prof, prof, rows, 9));
+
+   sec = 50;
+   r.push_back(db::db_idx64_store(prof, rows, prof, 5, &sec));
+   sec = 40;
+   r.push_back(db::db_idx64_store(prof, rows, prof, 9, &sec));
+   sec = 45;
+   pk  = 0;
+   r.push_back(db::db_idx64_lowerbound(prof, prof, rows, &sec, &pk));
+   r.insert(r.end(), {int32_t(sec), int32_t(pk)});
+   sec = 0;
+   const int32_t by_sec = db::db_idx64_find_primary(prof, prof, rows, &sec, 9);
+   r.insert(r.end(), {by_sec, int32_t(sec)});
+   r.push_back(db::db_idx64_next(by_sec, &pk));
+   r.push_back(pk);
+   r.push_back(db::db_idx64_end(prof, prof, rows));
+
+   r.push_back(kv::kv_set(prof, "k1", 2, "v1", 2, prof));
+   r.push_back(kv::kv_set(prof, "k2", 2, "v22", 3, prof));
+   r.push_back(kv::kv_set(prof, "k2", 2, "v2", 2, prof));
+   r.push_back(kv::kv_get(prof, "k2", 2, vs));
+   r.push_back(vs);
+   r.push_back(kv::kv_erase(prof, "k1", 2));
+   r.push_back(kv::kv_set(prof, "k3", 2, "v3", 2, prof));
+   const uint32_t itr = kv::kv_it_create(prof, "k", 1);
+   r.push_back(itr);
+   r.push_back(kv::kv_it_next(itr, ks, vs));
+   r.insert(r.end(), {int32_t(ks), int32_t(vs)});
+   r.push_back(kv::kv_it_next(itr, ks, vs));
+   r.push_back(kv::kv_it_next(itr, ks, vs));
+   r.push_back(kv::kv_it_status(itr));
+   r.push_back(kv::kv_it_lower_bound(itr, "k25", 3, ks, vs));
+   r.insert(r.end(), {int32_t(ks), int32_t(vs)});
+   const uint32_t itr2 = kv::kv_it_create(prof, "k", 1);
+   r.push_back(itr2);
+   r.push_back(kv::kv_it_prev(itr2, ks, vs));
+   r.push_back(kv::kv_it_compare(itr, itr2));
+   r.push_back(kv::kv_it_key_compare(itr, "k3", 2));
+   kv::kv_erase(prof, "k3", 2);
+   r.push_back(kv::kv_it_status(itr));
+
+   CHECK_EQUAL( r, (vector<int32_t>{0, 1, -2, 1, -2, 1, -2, 1, 9, 1, 9, -2, -1, -2,
+                                    0, 1, 0, 50, 5, 1, 40, 0, 5, -2,
+                                    4, 5, -1, 1, 2, -4, 4, 1, 0, 2, 2, 0, -2, -2, 0, 2, 2, 2, 0, 0, 0, -1}) )
+   CHECK_EQUAL( chain_state::row_count("prof"_n, prof, "rows"_n), 1u )
+   CHECK_EQUAL( chain_state::kv_size("prof"_n), 1u )
+EOSIO_TEST_END
+
+int main(int argc, char* argv[]) {
+   bool verbose = false;
+   if( argc >= 2 && std::strcmp( argv[1], "-v" ) == 0 ) {
+      verbose = true;
+   }
+   silence_output(!verbose);
+
+   EOSIO_TEST(chain_state_multi_index_test)
+   EOSIO_TEST(chain_state_key_iterator_test)
+   EOSIO_TEST(chain_state_modify_fields_test)
+   EOSIO_TEST(chain_state_emplace_many_test)
+   EOSIO_TEST(chain_state_lru_cache_test)
+   EOSIO_TEST(chain_state_kv_table_test)
+   EOSIO_TEST(chain_state_kv_put_test)
+   EOSIO_TEST(chain_state_kv_map_test)
+   EOSIO_TEST(chain_state_profile_test)
+   return has_failed();
+}
@@ -12,6 +12,7 @@
 
 #include <eosio/tester.hpp>
 #include <eosio/binary_extension.hpp>
+#include <eosio/bytes_view.hpp>
 #include <eosio/crypto.hpp>
 #include <eosio/datastream.hpp>
 #include <eosio/ignore.hpp>
@@ -33,6 +34,7 @@ using std::variant;
 using std::vector;
 
 using eosio::binary_extension;
+using eosio::bytes_view;
 using eosio::datastream;
 using eosio::fixed_bytes;
 using eosio::ignore;
@@ -385,6 +387,33 @@ EOSIO_TEST_BEGIN(datastream_stream_test)
    ds >> str;
    CHECK_EQUAL( cstr, str )
 
+   // ----------------
+   // std::string_view
+   ds.seekp(0);
+   fill(begin(datastream_buffer), end(datastream_buffer), 0);
+   static const std::string_view csv {"abcdefghi"};
+   std::string_view sv{};
+   ds << csv;
+   ds.seekp(0);
+   ds >> sv;
+   CHECK_EQUAL( csv, sv )
+   // the view points into the stream's buffer rather than a copy
+   CHECK_EQUAL( sv.data(), datastream_buffer+1 )
+   CHECK_EQUAL( ds.tellp(), 10 )
+
+   // ----------------
+   // eosio::bytes_view
+   ds.seekp(0);
+   fill(begin(datastream_buffer), end(datastream_buffer), 0);
+   static const vector<char> cbv_src{'a','b','c','d','e'};
+   bytes_view bv{};
+   ds << bytes_view{cbv_src};
+   ds.seekp(0);
+   ds >> bv;
+   CHECK_EQUAL( bv.to_vector(), cbv_src )
+   CHECK_EQUAL( bv.data(), datastream_buffer+1 )
+   CHECK_EQUAL( pack(bytes_view{cbv_src}), pack(cbv_src) )
+
    // ----------
    // std::tuple
    ds.seekp(0);
@@ -0,0 +1,104 @@
+/**
+ *  @file
+ *  @copyright defined in eosio.cdt/LICENSE.txt
+ */
+
+#include <string>
+
+#include <eosio/eosio.hpp>
+#include <eosio/map.hpp>
+#include <eosio/tester.hpp>
+
+using std::string;
+
+using eosio::name;
+using eosio::native::chain_state;
+using eosio::native::intrinsics;
+using eosio::native::intrinsic_stats;
+
+static constexpr name self = "stats"_n;
+
+// Definitions in `eosio.cdt/libraries/native/native/eosio/intrinsics.hpp`
+EOSIO_TEST_BEGIN(intrinsic_stats_test)
+   chain_state::install(self);
+   chain_state::reset();
+   intrinsics::reset_stats();
+
+   // nothing is recorded until statistics are enabled
+   kv_set(self.value, "ab", 2, "xyz", 3, self.value);
+   CHECK_EQUAL( intrinsics::snapshot_stats().calls(), 0ull )
+
+   intrinsics::enable_stats();
+   kv_set(self.value, "ab", 2, "xyzw", 4, self.value);
+   uint32_t value_size = 0;
+   CHECK_EQUAL( kv_get(self.value, "ab", 2, value_size), true )
+   CHECK_EQUAL( value_size, 4u )
+
+   auto before = intrinsics::snapshot_stats();
+   CHECK_EQUAL( before[intrinsics::kv_set].calls, 1ull )
+   // key and value buffers
+   CHECK_EQUAL( before[intrinsics::kv_set].bytes, 6ull )
+   CHECK_EQUAL( before[intrinsics::kv_get].bytes, 2ull )
+   CHECK_EQUAL( before.calls("kv_"), 2ull )
+   CHECK_EQUAL( before.calls("db_"), 0ull )
+
+   const auto& set_stats = before[intrinsics::kv_set];
+   uint64_t bucketed = 0;
+   for (auto n : set_stats.histogram)
+      bucketed += n;
+   CHECK_EQUAL( bucketed, set_stats.calls )
+
+   // a snapshot difference only holds the calls made in between, here the lookup, the default insert and the write
+   eosio::kv::map<"balances"_n, string, uint64_t> m{self};
+   m["alice"] = 10;
+   auto diff = intrinsics::snapshot_stats() - before;
+   CHECK_EQUAL( diff[intrinsics::kv_get].calls, 1ull )
+   CHECK_EQUAL( diff[intrinsics::kv_set].calls, 2ull )
+   CHECK_EQUAL( diff.calls("kv_") <= 3, true )
+
+   uint64_t row = 7;
+   db_store_i64(self.value, "rows"_n.value, self.value, 1, &row, sizeof(row));
+   diff = intrinsics::snapshot_stats() - before;
+   CHECK_EQUAL( diff[intrinsics::db_store_i64].bytes, 8ull )
+   CHECK_EQUAL( diff.bytes("db_"), 8ull )
+
+   CHECK_EQUAL( string(intrinsics::name_of(intrinsics::kv_it_next)), string("kv_it_next") )
+
+   const string json = before.to_json();
+   CHECK_EQUAL( json.find("\"kv_set\":{\"calls\":1,\"bytes\":6,") != string::npos, true )
+   CHECK_EQUAL( json.find("db_store_i64"), string::npos )
+
+   intrinsics::reset_stats();
+   CHECK_EQUAL( intrinsics::snapshot_stats().calls(), 0ull )
+   CHECK_EQUAL( intrinsics::snapshot_stats().to_json(), string("{}") )
+
+   intrinsics::enable_stats(false);
+   kv_set(self.value, "ab", 2, "x", 1, self.value);
+   CHECK_EQUAL( intrinsics::snapshot_stats().calls(), 0ull )
+EOSIO_TEST_END
+
+EOSIO_TEST_BEGIN(intrinsic_stats_histogram_test)
+   intrinsic_stats s;
+   s.record_time(0);
+   s.record_time(1);
+   s.record_time(3);
+   s.record_time(1000);
+   s.record_time(uint64_t(1) << 40);
+   CHECK_EQUAL( s.histogram[0], 2ull )
+   CHECK_EQUAL( s.histogram[1], 1ull )
+   CHECK_EQUAL( s.histogram[9], 1ull )
+   CHECK_EQUAL( s.histogram[intrinsic_stats::histogram_buckets - 1], 1ull )
+   CHECK_EQUAL( s.nanoseconds, 1004ull + (uint64_t(1) << 40) )
+EOSIO_TEST_END
+
+int main(int argc, char* argv[]) {
+   bool verbose = false;
+   if( argc >= 2 && std::strcmp( argv[1], "-v" ) == 0 ) {
+      verbose = true;
+   }
+   silence_output(!verbose);
+
+   EOSIO_TEST(intrinsic_stats_test)
+   EOSIO_TEST(intrinsic_stats_histogram_test)
+   return has_failed();
+}
@@ -0,0 +1,144 @@
+/**
+ *  @file
+ *  @copyright defined in eosio.cdt/LICENSE.txt
+ */
+
+#include <cstring>
+#include <initializer_list>
+
+#include <eosio/tester.hpp>
+#include <eosiolib/memory.hpp>
+
+// byte at a time references for the word at a time eosio::cmem primitives backing memcpy, memmove, memset and memcmp
+namespace reference {
+   void copy( uint8_t* dst, const uint8_t* src, size_t n ) {
+      for ( size_t i=0; i < n; i++ )
+         dst[i] = src[i];
+   }
+   void move( uint8_t* dst, const uint8_t* src, size_t n ) {
+      if ( dst < src ) {
+         for ( size_t i=0; i < n; i++ )
+            dst[i] = src[i];
+      } else {
+         for ( size_t i=n; i > 0; i-- )
+            dst[i-1] = src[i-1];
+      }
+   }
+   void fill( uint8_t* dst, int c, size_t n ) {
+      for ( size_t i=0; i < n; i++ )
+         dst[i] = (uint8_t)c;
+   }
+   int compare( const uint8_t* a, const uint8_t* b, size_t n ) {
+      for ( size_t i=0; i < n; i++ ) {
+         if ( a[i] != b[i] )
+            return a[i] < b[i] ? -1 : 1;
+      }
+      return 0;
+   }
+} // ns reference
+
+static constexpr size_t buffer_size = 4096 + 64;
+static uint8_t src_buf[buffer_size];
+static uint8_t dst_buf[buffer_size];
+static uint8_t ref_buf[buffer_size];
+
+// sizes around the word size and the unrolled block size, at every alignment of source and destination
+static constexpr size_t test_sizes[] = {0, 1, 3, 7, 8, 9, 15, 16, 31, 33, 64, 100, 257, 1024, 4009};
+
+static void scramble( uint8_t* buf, size_t n, uint32_t seed ) {
+   for ( size_t i=0; i < n; i++ ) {
+      seed = seed * 1103515245 + 12345;
+      buf[i] = uint8_t(seed >> 16);
+   }
+}
+
+static bool same_buffers() {
+   return std::memcmp( ref_buf, dst_buf, buffer_size ) == 0;
+}
+
+template <typename F>
+static void for_each_case( F&& f ) {
+   for ( size_t n : test_sizes )
+      for ( size_t soff = 0; soff < 8; soff++ )
+         for ( size_t doff = 0; doff < 8; doff++ )
+            f( n, soff, doff );
+}
+
+// Defined in `eosio.cdt/libraries/eosiolib/memory.hpp`
+EOSIO_TEST_BEGIN(cmem_copy_test)
+   for_each_case( [&]( size_t n, size_t soff, size_t doff ) {
+      scramble( src_buf, buffer_size, n + soff );
+      scramble( dst_buf, buffer_size, doff );
+      std::memcpy( ref_buf, dst_buf, buffer_size );
+
+      reference::copy( ref_buf + doff, src_buf + soff, n );
+      CHECK_EQUAL( eosio::cmem::copy( dst_buf + doff, src_buf + soff, n ), (void*)(dst_buf + doff) )
+      CHECK_EQUAL( same_buffers(), true )
+   });
+EOSIO_TEST_END
+
+// Defined in `eosio.cdt/libraries/eosiolib/memory.hpp`
+EOSIO_TEST_BEGIN(cmem_move_test)
+   for_each_case( [&]( size_t n, size_t soff, size_t doff ) {
+      scramble( ref_buf, buffer_size, n + soff + doff );
+      std::memcpy( dst_buf, ref_buf, buffer_size );
+
+      // overlapping moves in both directions within one buffer
+      reference::move( ref_buf + doff, ref_buf + soff + 8, n );
+      CHECK_EQUAL( eosio::cmem::move( dst_buf + doff, dst_buf + soff + 8, n ), (void*)(dst_buf + doff) )
+      CHECK_EQUAL( same_buffers(), true )
+
+      reference::move( ref_buf + soff + 8, ref_buf + doff, n );
+      eosio::cmem::move( dst_buf + soff + 8, dst_buf + doff, n );
+      CHECK_EQUAL( same_buffers(), true )
+   });
+EOSIO_TEST_END
+
+// Defined in `eosio.cdt/libraries/eosiolib/memory.hpp`
+EOSIO_TEST_BEGIN(cmem_fill_test)
+   for_each_case( [&]( size_t n, size_t soff, size_t doff ) {
+      scramble( dst_buf, buffer_size, doff );
+      std::memcpy( ref_buf, dst_buf, buffer_size );
+
+      // only the low byte of the value is used
+      const int c = int(0x100 * soff + n);
+      reference::fill( ref_buf + doff, c, n );
+      CHECK_EQUAL( eosio::cmem::fill( dst_buf + doff, c, n ), (void*)(dst_buf + doff) )
+      CHECK_EQUAL( same_buffers(), true )
+   });
+EOSIO_TEST_END
+
+// Defined in `eosio.cdt/libraries/eosiolib/memory.hpp`
+EOSIO_TEST_BEGIN(cmem_compare_test)
+   for_each_case( [&]( size_t n, size_t soff, size_t doff ) {
+      scramble( src_buf, buffer_size, n + soff );
+      std::memcpy( dst_buf, src_buf, buffer_size );
+      CHECK_EQUAL( eosio::cmem::compare( src_buf + doff, dst_buf + doff, n ), 0 )
+
+      if ( n > 0 ) {
+         // a difference in the first, a middle or the last byte, where the bytes compare as unsigned
+         for ( size_t at : {size_t(0), soff % n, n - 1} ) {
+            std::memcpy( dst_buf, src_buf, buffer_size );
+            dst_buf[doff + at] ^= 0x80;
+            CHECK_EQUAL( eosio::cmem::compare( src_buf + doff, dst_buf + doff, n ),
+                         reference::compare( src_buf + doff, dst_buf + doff, n ) )
+            CHECK_EQUAL( eosio::cmem::compare( dst_buf + doff, src_buf + doff, n ),
+                         reference::compare( dst_buf + doff, src_buf + doff, n ) )
+         }
+      }
+   });
+EOSIO_TEST_END
+
+int main(int argc, char* argv[]) {
+   bool verbose = false;
+   if( argc >= 2 && std::strcmp( argv[1], "-v" ) == 0 ) {
+      verbose = true;
+   }
+   silence_output(!verbose);
+
+   EOSIO_TEST(cmem_copy_test)
+   EOSIO_TEST(cmem_move_test)
+   EOSIO_TEST(cmem_fill_test)
+   EOSIO_TEST(cmem_compare_test)
+   return has_failed();
+}
@@ -0,0 +1,220 @@
+/**
+ *  @file
+ *  @copyright defined in eosio.cdt/LICENSE.txt
+ */
+
+#include <algorithm>
+#include <map>
+#include <vector>
+
+#include <eosio/eosio.hpp>
+#include <eosio/multi_index.hpp>
+#include <eosio/tester.hpp>
+
+using std::vector;
+
+using eosio::multi_index;
+using eosio::name;
+using eosio::native::chain_state;
+using eosio::native::intrinsics;
+using eosio::_multi_index_detail::item_cache_index;
+
+static constexpr name self = "multiindex"_n;
+
+// the bucket item_cache_index starts probing at for `key`, with `capacity` buckets
+static size_t home_bucket( uint64_t key, size_t capacity ) {
+   uint32_t shift = 64;
+   for( size_t c = capacity; c > 1; c >>= 1 )
+      --shift;
+   return static_cast<size_t>( (key * 0x9E3779B97F4A7C15ULL) >> shift );
+}
+
+// the first `count` keys from `start` on whose home bucket is one of [first, last]
+static vector<uint64_t> keys_homed_at( size_t first, size_t last, size_t count, uint64_t start = 1, size_t capacity = 64 ) {
+   vector<uint64_t> keys;
+   for( uint64_t k = start; keys.size() < count; ++k ) {
+      const size_t home = home_bucket( k, capacity );
+      if( home >= first && home <= last )
+         keys.push_back( k );
+   }
+   return keys;
+}
+
+// whether the index maps exactly the keys of `expected`, to the same slots
+static bool same_entries( const item_cache_index& index, const std::map<uint64_t, uint32_t>& expected, const vector<uint64_t>& erased ) {
+   if( index.size() != expected.size() )
+      return false;
+   for( const auto& [key, slot] : expected )
+      if( index.find(key) != slot )
+         return false;
+   for( auto key : erased )
+      if( expected.count(key) == 0 && index.find(key) != item_cache_index::npos )
+         return false;
+   return true;
+}
+
+struct row {
+   uint64_t id;
+   uint64_t value;
+
+   uint64_t primary_key() const { return id; }
+
+   EOSLIB_SERIALIZE( row, (id)(value) )
+};
+
+using rows = multi_index<"rows"_n, row>;
+
+// Defined in `eosio.cdt/libraries/eosiolib/contracts/eosio/multi_index.hpp`
+EOSIO_TEST_BEGIN(item_cache_index_test)
+   item_cache_index index;
+   std::map<uint64_t, uint32_t> expected;
+   vector<uint64_t> erased;
+
+   CHECK_EQUAL( index.find(1), item_cache_index::npos )
+   index.erase(1);
+   CHECK_EQUAL( index.size(), 0u )
+
+   // 17 entries grow the table past 16 and then 32 buckets, homed well before the last buckets
+   uint32_t slot = 0;
+   for( auto key : keys_homed_at(8, 40, 17) ) {
+      index.set( key, slot );
+      expected[key] = slot++;
+   }
+   CHECK_EQUAL( same_entries(index, expected, erased), true )
+
+   // a probe run that wraps from the last bucket to the first ones: a, b and d are homed at bucket 63, c at bucket 0
+   // and e at bucket 1, so they land in buckets 63, 0, 1, 2 and 3
+   const auto last = keys_homed_at(63, 63, 3, 1000);
+   const uint64_t a = last[0], b = last[1], d = last[2];
+   const uint64_t c = keys_homed_at(0, 0, 1, 1000)[0];
+   const uint64_t e = keys_homed_at(1, 1, 1, 1000)[0];
+   for( auto key : {a, b, c, d, e} ) {
+      index.set( key, slot );
+      expected[key] = slot++;
+   }
+   CHECK_EQUAL( same_entries(index, expected, erased), true )
+
+   // setting a present key only moves it to the new slot
+   index.set( c, 100 );
+   expected[c] = 100;
+   CHECK_EQUAL( same_entries(index, expected, erased), true )
+
+   // erasing the head of the run in the last bucket shifts every entry behind it back across the wrap
+   for( auto key : {a, c, e, b, d} ) {
+      index.erase( key );
+      expected.erase( key );
+      erased.push_back( key );
+      CHECK_EQUAL( same_entries(index, expected, erased), true )
+   }
+
+   // erasing from the middle of a run within the table
+   const auto middle = keys_homed_at(20, 20, 4, 5000);
+   for( auto key : middle ) {
+      index.set( key, slot );
+      expected[key] = slot++;
+   }
+   for( auto i : {1, 0, 3, 2} ) {
+      index.erase( middle[i] );
+      expected.erase( middle[i] );
+      erased.push_back( middle[i] );
+      CHECK_EQUAL( same_entries(index, expected, erased), true )
+   }
+
+   // random sets and erases over keys homed around the wrap, few enough to stay within 64 buckets
+   const auto pool = keys_homed_at(60, 63, 7, 1);
+   const auto wrapped = keys_homed_at(0, 3, 7, 1);
+   vector<uint64_t> keys = pool;
+   keys.insert( keys.end(), wrapped.begin(), wrapped.end() );
+   uint32_t seed = 42;
+   bool consistent = true;
+   for( int i = 0; i < 2000; ++i ) {
+      seed = seed * 1103515245 + 12345;
+      const uint64_t key = keys[(seed >> 16) % keys.size()];
+      if( (seed >> 8) & 1 ) {
+         index.set( key, i );
+         expected[key] = i;
+      } else {
+         index.erase( key );
+         expected.erase( key );
+      }
+      consistent &= same_entries( index, expected, keys );
+   }
+   CHECK_EQUAL( consistent, true )
+
+   index.clear();
+   CHECK_EQUAL( index.size(), 0u )
+   CHECK_EQUAL( index.find(middle[0]), item_cache_index::npos )
+EOSIO_TEST_END
+
+// Defined in `eosio.cdt/libraries/eosiolib/contracts/eosio/multi_index.hpp`
+EOSIO_TEST_BEGIN(multi_index_item_cache_test)
+   chain_state::install(self);
+   chain_state::reset();
+
+   // 24 rows, whose primary keys include a probe run across the wrap of the 64 bucket primary key index
+   vector<uint64_t> ids = keys_homed_at(8, 40, 17);
+   const auto last = keys_homed_at(63, 63, 3, 1000);
+   const auto first = keys_homed_at(0, 1, 4, 1000);
+   ids.insert( ids.end(), last.begin(), last.end() );
+   ids.insert( ids.end(), first.begin(), first.end() );
+   {
+      rows t{self, self.value};
+      for( auto id : ids )
+         t.emplace(self, [&](auto& r) { r = row{id, id * 10}; });
+   }
+
+   // a fresh table object loads and caches every row
+   rows t{self, self.value};
+   size_t loaded = 0;
+   for( const auto& r : t )
+      loaded += r.value == r.id * 10;
+   CHECK_EQUAL( loaded, ids.size() )
+
+   // erase from the middle of the cached rows and from both ends of the wrapped run, then check that every other
+   // row is still found in the cache, as the same object, by its primary key and by its iterator
+   vector<uint64_t> erased = {ids[5], last[0], first[1], first[3], ids[16]};
+   for( auto id : erased )
+      t.erase(t.find(id));
+
+   intrinsics::reset_stats();
+   intrinsics::enable_stats();
+   bool found = true;
+   for( auto id : ids ) {
+      const bool was_erased = std::find(erased.begin(), erased.end(), id) != erased.end();
+      auto itr = t.find(id);
+      if( was_erased ) {
+         found &= itr == t.end();
+         continue;
+      }
+      found &= itr != t.end() && itr->id == id && itr->value == id * 10;
+      found &= &t.get(id) == &*itr;
+      found &= t.iterator_to(*itr) == itr;
+   }
+   intrinsics::enable_stats(false);
+   CHECK_EQUAL( found, true )
+   CHECK_EQUAL( intrinsics::snapshot_stats()[intrinsics::db_get_i64].calls, 0ull )
+
+   // iteration still visits the remaining rows in key order
+   vector<uint64_t> remaining;
+   for( const auto& r : t )
+      remaining.push_back( r.id );
+   vector<uint64_t> sorted;
+   for( auto id : ids )
+      if( std::find(erased.begin(), erased.end(), id) == erased.end() )
+         sorted.push_back( id );
+   std::sort( sorted.begin(), sorted.end() );
+   CHECK_EQUAL( remaining, sorted )
+   CHECK_EQUAL( chain_state::row_count(self, self.value, "rows"_n), sorted.size() )
+EOSIO_TEST_END
+
+int main(int argc, char* argv[]) {
+   bool verbose = false;
+   if( argc >= 2 && std::strcmp( argv[1], "-v" ) == 0 ) {
+      verbose = true;
+   }
+   silence_output(!verbose);
+
+   EOSIO_TEST(item_cache_index_test)
+   EOSIO_TEST(multi_index_item_cache_test)
+   return has_failed();
+}
@@ -0,0 +1,45 @@
+#!/bin/bash
+set -eo pipefail
+# The purpose of this test is to ensure that eosio-pp drops the functions and globals no export, start function or
+# element segment reaches, and keeps and renumbers everything else
+echo '##### Eosio-pp Dead Code Elimination Test #####'
+# orient ourselves
+[[ -z "$BUILD_ROOT" ]] && export BUILD_ROOT="$(pwd)"
+echo "Using BUILD_ROOT=\"$BUILD_ROOT\"."
+FIXTURE="$BUILD_ROOT/tests/unit/postpass_tests.wast"
+WORK_DIR="$(mktemp -d)"
+trap "rm -rf \"$WORK_DIR\"" EXIT
+# assemble, post process and disassemble the fixture
+$BUILD_ROOT/bin/eosio-wast2wasm "$FIXTURE" -o "$WORK_DIR/in.wasm"
+$BUILD_ROOT/bin/eosio-pp "$WORK_DIR/in.wasm" -o "$WORK_DIR/out.wasm"
+ACTUAL="$($BUILD_ROOT/bin/eosio-wasm2wast "$WORK_DIR/out.wasm")"
+FAILED=0
+expect() {
+    if [[ "$(grep -c -- "$2" <<< "$ACTUAL")" -ne "$1" ]]; then
+        echo "Expected $1 line(s) matching \"$2\"."
+        FAILED=1
+    fi
+}
+# the imports stay, used or not, and the exported, called and call_indirect-only functions are kept
+expect 2 '(import "env"'
+expect 3 '^  (func '
+expect 1 'i32.const 110001'
+expect 1 'i32.const 110002'
+# the unreachable cycle and the unused function are dropped
+expect 0 'i32.const 91000'
+# so are the unused globals, the references to those that are kept are renumbered
+expect 2 '^  (global '
+expect 1 'i32.const 8192'
+expect 1 'i32.const 100001'
+expect 0 'i32.const 900001'
+expect 1 'get_global 1'
+expect 1 '(export "apply" (func 2))'
+expect 1 '(elem (i32.const 1) 4)'
+expect 1 'call 3'
+if [[ $FAILED -eq 0 ]]; then
+    echo 'Passed.'
+    exit 0
+fi
+echo 'Failed!'
+echo "$ACTUAL"
+exit 1
@@ -0,0 +1,43 @@
+;; eosio-pp dead code elimination: every function and global that is kept returns or holds a 1xxxxx constant, every
+;; one that has to go a 9xxxxx constant
+(module
+  (type $i32_fn (func (result i32)))
+  (import "env" "eosio_assert" (func $eosio_assert (param i32 i32)))
+  (import "env" "prints" (func $prints (param i32)))
+  (table 2 2 anyfunc)
+  (memory 1)
+  (global $stack_ptr (mut i32) (i32.const 8192))
+  (global $heap_ptr i32 (i32.const 8200))
+  (global $used (mut i32) (i32.const 100001))
+  (global $unused (mut i32) (i32.const 900001))
+  (export "memory" (memory 0))
+  (export "apply" (func $apply))
+  (elem (i32.const 1) $indirect_only)
+  (func $apply (param i64 i64 i64)
+    get_global $stack_ptr
+    call $called
+    i32.const 1
+    call_indirect (type $i32_fn)
+    i32.add
+    call $eosio_assert)
+  (func $called (result i32)
+    i32.const 110001
+    get_global $used
+    i32.add)
+  ;; only reachable through the table
+  (func $indirect_only (result i32)
+    i32.const 110002)
+  ;; a cycle nothing else calls
+  (func $cycle_a (result i32)
+    i32.const 910001
+    call $cycle_b
+    i32.add)
+  (func $cycle_b (result i32)
+    i32.const 910002
+    call $cycle_a
+    i32.add)
+  (func $unused_fn (result i32)
+    i32.const 910003
+    get_global $unused
+    i32.add)
+  (data (i32.const 16) "live"))
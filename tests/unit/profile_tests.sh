@@ -0,0 +1,31 @@
+#!/bin/bash
+set -eo pipefail
+# The purpose of this test is to ensure that the chain state of eosio-profile hands out the same iterator handles and
+# results as the chain state of the native tester, which it duplicates
+echo '##### Eosio-profile Chain State Test #####'
+# orient ourselves
+[[ -z "$BUILD_ROOT" ]] && export BUILD_ROOT="$(pwd)"
+echo "Using BUILD_ROOT=\"$BUILD_ROOT\"."
+FIXTURE="$BUILD_ROOT/tests/unit/profile_tests.wast"
+WORK_DIR="$(mktemp -d)"
+trap "rm -rf \"$WORK_DIR\"" EXIT
+# the values chain_state_profile_test expects, 4 bytes each, followed by the rows and kv pairs the calls leave behind
+EXPECTED="row prof prof results 0 prof $(for v in \
+    00000000 01000000 feffffff 01000000 feffffff 01000000 feffffff 01000000 09000000 01000000 \
+    09000000 feffffff ffffffff feffffff 00000000 01000000 00000000 32000000 05000000 01000000 \
+    28000000 00000000 05000000 feffffff 04000000 05000000 ffffffff 01000000 02000000 fcffffff \
+    04000000 01000000 00000000 02000000 02000000 00000000 feffffff feffffff 00000000 02000000 \
+    02000000 02000000 00000000 00000000 00000000 ffffffff; do echo -n $v; done)
+row prof prof rows 5 prof 636363
+kv prof 6b32 7632"
+echo "Expecting \"$EXPECTED\"..."
+$BUILD_ROOT/bin/eosio-wast2wasm "$FIXTURE" -o "$WORK_DIR/state.wasm"
+$BUILD_ROOT/bin/eosio-profile "$WORK_DIR/state.wasm" -r prof -a run --save-state "$WORK_DIR/state.txt" > /dev/null
+ACTUAL="$(cat "$WORK_DIR/state.txt")"
+if [[ "$EXPECTED" == "$ACTUAL" ]]; then
+    echo 'Passed.'
+    exit 0
+fi
+echo 'Failed!'
+echo "\"$EXPECTED\" != \"$ACTUAL\""
+exit 1
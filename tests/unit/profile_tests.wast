@@ -0,0 +1,121 @@
+;; eosio-profile chain state: records the iterator handles, primary keys, sizes and results of a sequence of db and kv
+;; calls to the row prof/prof/results 0, 4 bytes each.  chain_state_profile_test in chain_state_tests.cpp makes the
+;; same calls against the native tester's chain state and expects the same values.
+(module
+  (import "env" "db_store_i64" (func $db_store_i64 (param i64 i64 i64 i64 i32 i32) (result i32)))
+  (import "env" "db_update_i64" (func $db_update_i64 (param i32 i64 i32 i32)))
+  (import "env" "db_remove_i64" (func $db_remove_i64 (param i32)))
+  (import "env" "db_next_i64" (func $db_next_i64 (param i32 i32) (result i32)))
+  (import "env" "db_previous_i64" (func $db_previous_i64 (param i32 i32) (result i32)))
+  (import "env" "db_find_i64" (func $db_find_i64 (param i64 i64 i64 i64) (result i32)))
+  (import "env" "db_lowerbound_i64" (func $db_lowerbound_i64 (param i64 i64 i64 i64) (result i32)))
+  (import "env" "db_upperbound_i64" (func $db_upperbound_i64 (param i64 i64 i64 i64) (result i32)))
+  (import "env" "db_end_i64" (func $db_end_i64 (param i64 i64 i64) (result i32)))
+  (import "env" "db_idx64_store" (func $db_idx64_store (param i64 i64 i64 i64 i32) (result i32)))
+  (import "env" "db_idx64_lowerbound" (func $db_idx64_lowerbound (param i64 i64 i64 i32 i32) (result i32)))
+  (import "env" "db_idx64_find_primary" (func $db_idx64_find_primary (param i64 i64 i64 i32 i64) (result i32)))
+  (import "env" "db_idx64_next" (func $db_idx64_next (param i32 i32) (result i32)))
+  (import "env" "db_idx64_end" (func $db_idx64_end (param i64 i64 i64) (result i32)))
+  (import "env" "kv_set" (func $kv_set (param i64 i32 i32 i32 i32 i64) (result i64)))
+  (import "env" "kv_get" (func $kv_get (param i64 i32 i32 i32) (result i32)))
+  (import "env" "kv_erase" (func $kv_erase (param i64 i32 i32) (result i64)))
+  (import "env" "kv_it_create" (func $kv_it_create (param i64 i32 i32) (result i32)))
+  (import "env" "kv_it_status" (func $kv_it_status (param i32) (result i32)))
+  (import "env" "kv_it_compare" (func $kv_it_compare (param i32 i32) (result i32)))
+  (import "env" "kv_it_key_compare" (func $kv_it_key_compare (param i32 i32 i32) (result i32)))
+  (import "env" "kv_it_next" (func $kv_it_next (param i32 i32 i32) (result i32)))
+  (import "env" "kv_it_prev" (func $kv_it_prev (param i32 i32 i32) (result i32)))
+  (import "env" "kv_it_lower_bound" (func $kv_it_lower_bound (param i32 i32 i32 i32 i32) (result i32)))
+  (memory 1)
+  (export "memory" (memory 0))
+  (export "apply" (func $apply))
+  ;; the results go to memory from 1024 on, 4 bytes each
+  (global $out (mut i32) (i32.const 1024))
+  (func $rec (param $value i32)
+    get_global $out
+    get_local $value
+    i32.store
+    get_global $out
+    i32.const 4
+    i32.add
+    set_global $out)
+  (func $rec64 (param $value i64)
+    get_local $value
+    i32.wrap/i64
+    call $rec)
+  (func $pk (result i32)
+    i32.const 200
+    i32.load)
+  (func $apply (param $receiver i64) (param $code i64) (param $action i64)
+    (local $a i32) (local $b i32) (local $end i32) (local $itr i32) (local $itr2 i32)
+    ;; primary index: two rows in prof/prof/rows
+    (set_local $a (call $db_store_i64 (get_local $receiver) (i64.const 0xbd39800000000000) (get_local $receiver) (i64.const 5) (i32.const 100) (i32.const 2)))
+    (call $rec (get_local $a))
+    (set_local $b (call $db_store_i64 (get_local $receiver) (i64.const 0xbd39800000000000) (get_local $receiver) (i64.const 9) (i32.const 102) (i32.const 2)))
+    (call $rec (get_local $b))
+    (set_local $end (call $db_end_i64 (get_local $receiver) (get_local $receiver) (i64.const 0xbd39800000000000)))
+    (call $rec (get_local $end))
+    (call $rec (call $db_find_i64 (get_local $receiver) (get_local $receiver) (i64.const 0xbd39800000000000) (i64.const 9)))
+    (call $rec (call $db_find_i64 (get_local $receiver) (get_local $receiver) (i64.const 0xbd39800000000000) (i64.const 7)))
+    (call $rec (call $db_lowerbound_i64 (get_local $receiver) (get_local $receiver) (i64.const 0xbd39800000000000) (i64.const 6)))
+    (call $rec (call $db_upperbound_i64 (get_local $receiver) (get_local $receiver) (i64.const 0xbd39800000000000) (i64.const 9)))
+    (call $rec (call $db_next_i64 (get_local $a) (i32.const 200)))
+    (call $rec (call $pk))
+    (i64.store (i32.const 200) (i64.const 0))
+    (call $rec (call $db_previous_i64 (get_local $end) (i32.const 200)))
+    (call $rec (call $pk))
+    (call $db_update_i64 (get_local $a) (get_local $receiver) (i32.const 104) (i32.const 3))
+    (call $db_remove_i64 (get_local $b))
+    (call $rec (call $db_next_i64 (get_local $a) (i32.const 200)))
+    ;; a table that never had rows
+    (call $rec (call $db_end_i64 (get_local $receiver) (get_local $receiver) (i64.const 0xa65aab8000000000)))
+    (call $rec (call $db_find_i64 (get_local $receiver) (get_local $receiver) (i64.const 0xbd39800000000000) (i64.const 9)))
+    ;; idx64: secondary keys 50 for row 5 and 40 for row 9
+    (i64.store (i32.const 208) (i64.const 50))
+    (call $rec (call $db_idx64_store (get_local $receiver) (i64.const 0xbd39800000000000) (get_local $receiver) (i64.const 5) (i32.const 208)))
+    (i64.store (i32.const 208) (i64.const 40))
+    (call $rec (call $db_idx64_store (get_local $receiver) (i64.const 0xbd39800000000000) (get_local $receiver) (i64.const 9) (i32.const 208)))
+    (i64.store (i32.const 208) (i64.const 45))
+    (i64.store (i32.const 200) (i64.const 0))
+    (call $rec (call $db_idx64_lowerbound (get_local $receiver) (get_local $receiver) (i64.const 0xbd39800000000000) (i32.const 208) (i32.const 200)))
+    (call $rec (i32.load (i32.const 208)))
+    (call $rec (call $pk))
+    (i64.store (i32.const 208) (i64.const 0))
+    (set_local $itr (call $db_idx64_find_primary (get_local $receiver) (get_local $receiver) (i64.const 0xbd39800000000000) (i32.const 208) (i64.const 9)))
+    (call $rec (get_local $itr))
+    (call $rec (i32.load (i32.const 208)))
+    (call $rec (call $db_idx64_next (get_local $itr) (i32.const 200)))
+    (call $rec (call $pk))
+    (call $rec (call $db_idx64_end (get_local $receiver) (get_local $receiver) (i64.const 0xbd39800000000000)))
+    ;; kv: k1 and k2 set, k2 shrunk, k1 erased, k3 set
+    (call $rec64 (call $kv_set (get_local $receiver) (i32.const 110) (i32.const 2) (i32.const 112) (i32.const 2) (get_local $receiver)))
+    (call $rec64 (call $kv_set (get_local $receiver) (i32.const 114) (i32.const 2) (i32.const 116) (i32.const 3) (get_local $receiver)))
+    (call $rec64 (call $kv_set (get_local $receiver) (i32.const 114) (i32.const 2) (i32.const 119) (i32.const 2) (get_local $receiver)))
+    (call $rec (call $kv_get (get_local $receiver) (i32.const 114) (i32.const 2) (i32.const 216)))
+    (call $rec (i32.load (i32.const 216)))
+    (call $rec64 (call $kv_erase (get_local $receiver) (i32.const 110) (i32.const 2)))
+    (call $rec64 (call $kv_set (get_local $receiver) (i32.const 121) (i32.const 2) (i32.const 123) (i32.const 2) (get_local $receiver)))
+    (set_local $itr (call $kv_it_create (get_local $receiver) (i32.const 125) (i32.const 1)))
+    (call $rec (get_local $itr))
+    (call $rec (call $kv_it_next (get_local $itr) (i32.const 220) (i32.const 224)))
+    (call $rec (i32.load (i32.const 220)))
+    (call $rec (i32.load (i32.const 224)))
+    (call $rec (call $kv_it_next (get_local $itr) (i32.const 220) (i32.const 224)))
+    (call $rec (call $kv_it_next (get_local $itr) (i32.const 220) (i32.const 224)))
+    (call $rec (call $kv_it_status (get_local $itr)))
+    (call $rec (call $kv_it_lower_bound (get_local $itr) (i32.const 126) (i32.const 3) (i32.const 220) (i32.const 224)))
+    (call $rec (i32.load (i32.const 220)))
+    (call $rec (i32.load (i32.const 224)))
+    (set_local $itr2 (call $kv_it_create (get_local $receiver) (i32.const 125) (i32.const 1)))
+    (call $rec (get_local $itr2))
+    (call $rec (call $kv_it_prev (get_local $itr2) (i32.const 220) (i32.const 224)))
+    (call $rec (call $kv_it_compare (get_local $itr) (get_local $itr2)))
+    (call $rec (call $kv_it_key_compare (get_local $itr) (i32.const 121) (i32.const 2)))
+    (drop (call $kv_erase (get_local $receiver) (i32.const 121) (i32.const 2)))
+    (call $rec (call $kv_it_status (get_local $itr)))
+    ;; everything recorded goes to row 0 of prof/prof/results
+    (drop (call $db_store_i64 (get_local $receiver) (i64.const 0xbab1a8e700000000) (get_local $receiver) (i64.const 0)
+                              (i32.const 1024) (i32.sub (get_global $out) (i32.const 1024)))))
+  (data (i32.const 100) "aabbccc")
+  (data (i32.const 110) "k1v1k2v22v2k3v3")
+  (data (i32.const 125) "kk25"))
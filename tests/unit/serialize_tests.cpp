@@ -10,8 +10,11 @@
 #include <vector>
 
 #include <eosio/tester.hpp>
+#include <eosio/asset.hpp>
 #include <eosio/datastream.hpp>
+#include <eosio/name.hpp>
 #include <eosio/serialize.hpp>
+#include <eosio/time.hpp>
 
 using std::begin;
 using std::end;
@@ -21,7 +24,15 @@ using std::string;
 using std::tie;
 using std::vector;
 
+using eosio::asset;
 using eosio::datastream;
+using eosio::is_bitwise_serializable;
+using eosio::name;
+using eosio::pack;
+using eosio::pack_size;
+using eosio::symbol;
+using eosio::time_point;
+using eosio::unpack;
 
 struct B {
    const char c{};
@@ -50,6 +61,59 @@ struct D2 : public D1 {
    }
 };
 
+struct fixed_row {
+   name       account;
+   uint64_t   id{};
+   asset      balance;
+   time_point updated;
+   EOSLIB_SERIALIZE( fixed_row, (account)(id)(balance)(updated) )
+
+   friend bool operator==(const fixed_row& lhs, const fixed_row& rhs) {
+      return tie(lhs.account, lhs.id, lhs.balance, lhs.updated) == tie(rhs.account, rhs.id, rhs.balance, rhs.updated);
+   }
+};
+
+struct account_key {
+   name     owner;
+   uint64_t id{};
+   EOSLIB_SERIALIZE( account_key, (owner)(id) )
+};
+
+// members listed out of declaration order
+struct reordered_row {
+   uint64_t a{};
+   uint32_t b{};
+   uint32_t c{};
+   EOSLIB_SERIALIZE( reordered_row, (a)(c)(b) )
+};
+
+// four bytes of tail padding
+struct padded_row {
+   uint64_t a{};
+   uint32_t b{};
+   EOSLIB_SERIALIZE( padded_row, (a)(b) )
+};
+
+// serialized through boost::pfr
+struct plain_row {
+   uint64_t a;
+   uint32_t b;
+   uint16_t c;
+   int16_t  d;
+};
+
+static_assert( is_bitwise_serializable<name>::value );
+static_assert( is_bitwise_serializable<asset>::value );
+static_assert( is_bitwise_serializable<time_point>::value );
+static_assert( is_bitwise_serializable<fixed_row>::value );
+static_assert( is_bitwise_serializable<std::array<fixed_row, 3>>::value );
+static_assert( !is_bitwise_serializable<bool>::value );
+static_assert( !is_bitwise_serializable<reordered_row>::value );
+static_assert( !is_bitwise_serializable<padded_row>::value );
+static_assert( !is_bitwise_serializable<D1>::value );
+static_assert( pack_size(account_key{}) == 16 );
+static_assert( pack_size(std::array<account_key, 4>{}) == 64 );
+
 // Definitions in `eosio.cdt/libraries/eosio/serialize.hpp`
 EOSIO_TEST_BEGIN(serialize_test)
    static constexpr uint16_t buffer_size{256};
@@ -101,6 +165,56 @@ EOSIO_TEST_BEGIN(serialize_test)
    REQUIRE_EQUAL( d2, dd2 )
 EOSIO_TEST_END
 
+// Fixed size records packed with a single copy in `eosio.cdt/libraries/eosio/serialize.hpp` and `datastream.hpp`
+EOSIO_TEST_BEGIN(bitwise_serialize_test)
+   static constexpr uint16_t buffer_size{256};
+   char ds_buffer[buffer_size]{};
+   char ds_expected_buffer[buffer_size]{};
+   datastream<char*> ds{ds_buffer, buffer_size};
+   datastream<char*> ds_expected{ds_expected_buffer, buffer_size};
+
+   const fixed_row row{"alice"_n, 42, asset{1234, symbol{"SYS", 4}}, time_point{eosio::seconds(1600000000)}};
+   ds_expected << row.account << row.id << row.balance.amount << row.balance.symbol << row.updated.elapsed._count;
+   ds << row;
+   CHECK_EQUAL( ds.tellp(), ds_expected.tellp() )
+   CHECK_EQUAL( memcmp(ds_buffer, ds_expected_buffer, buffer_size), 0 )
+   CHECK_EQUAL( pack_size(row), ds.tellp() )
+
+   fixed_row out;
+   ds.seekp(0);
+   ds >> out;
+   CHECK_EQUAL( row, out )
+   CHECK_EQUAL( unpack<fixed_row>(pack(row)), row )
+
+   // arrays and vectors of fixed size records keep their element by element layout
+   const std::array<fixed_row, 2> arr{row, row};
+   const vector<fixed_row> vec{row, row, row};
+   CHECK_EQUAL( pack(arr).size(), 2 * pack_size(row) )
+   CHECK_EQUAL( (unpack<std::array<fixed_row, 2>>(pack(arr))), arr )
+   CHECK_EQUAL( pack(vec).size(), 1 + 3 * pack_size(row) )
+   CHECK_EQUAL( unpack<vector<fixed_row>>(pack(vec)), vec )
+
+   // records that do not qualify still go field by field, in the listed order
+   const reordered_row rr{1, 2, 3};
+   const vector<char> rr_packed = pack(rr);
+   REQUIRE_EQUAL( rr_packed.size(), 16 )
+   CHECK_EQUAL( (unpack<uint32_t>(rr_packed.data() + 8, 4)), 3u )
+   CHECK_EQUAL( pack_size(padded_row{}), 12 )
+
+   const plain_row pr{1, 2, 3, -4};
+   const vector<char> pr_packed = pack(pr);
+   REQUIRE_EQUAL( pr_packed.size(), sizeof(plain_row) )
+   CHECK_EQUAL( memcmp(pr_packed.data(), &pr, sizeof(plain_row)), 0 )
+   CHECK_EQUAL( unpack<plain_row>(pr_packed).d, -4 )
+
+   // the whole record is bounds checked before anything is copied
+   char small[39]{};
+   datastream<char*> small_ds{small, sizeof(small)};
+   CHECK_ASSERT( "datastream attempted to write past the end", [&]() { small_ds << row; } )
+   CHECK_EQUAL( small_ds.tellp(), 0 )
+   CHECK_ASSERT( "datastream attempted to read past the end", [&]() { unpack<fixed_row>(small, sizeof(small)); } )
+EOSIO_TEST_END
+
 int main(int argc, char* argv[]) {
    bool verbose = false;
    if( argc >= 2 && std::strcmp( argv[1], "-v" ) == 0 ) {
@@ -109,5 +223,6 @@ int main(int argc, char* argv[]) {
    silence_output(!verbose);
 
    EOSIO_TEST(serialize_test)
+   EOSIO_TEST(bitwise_serialize_test)
    return has_failed();
 }
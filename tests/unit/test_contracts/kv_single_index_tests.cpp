@@ -273,6 +273,14 @@ public:
       expected = {s2, s5, s, s4, s3};
       vals = t.primary_key.range("alice"_n, "william"_n);
       eosio::check(vals == expected, "range did not return expected vector: {s2, s5, s, s4, s3}");
+
+      vals = {};
+      for (const auto& v : t.primary_key.view("alice"_n, "william"_n, 3)) {
+         vals.push_back(v);
+      }
+      expected = {s2, s5, s};
+      eosio::check(vals == expected, "view did not stop at its limit: {s2, s5, s}");
+      eosio::check(t.primary_key.view("joe"_n, "alice"_n).empty(), "view over an inverted range should be empty");
    }
 
    [[eosio::action]]
@@ -68,6 +68,30 @@ class [[eosio::contract]] malloc_tests : public contract{
          malloc_align_test<__int128_t>();
       }
 
+      [[eosio::action]]
+      void mallocfree() {
+         // make sure that freed memory is handed back out without clobbering live allocations
+         constexpr size_t count = 64;
+         char* ptrs[count];
+         for (size_t i = 0; i < count; ++i) {
+            const size_t sz = 1 + (i * 97) % 1500 + (i % 16 == 0 ? 40000 : 0);
+            ptrs[i] = (char*)malloc(sz);
+            memset(ptrs[i], (int)i, sz);
+         }
+         for (size_t i = 0; i < count; i += 2)
+            free(ptrs[i]);
+         for (size_t i = 0; i < count; i += 2) {
+            const size_t sz = 1 + (i * 89) % 1500 + (i % 16 == 0 ? 40000 : 0);
+            ptrs[i] = (char*)realloc(malloc(1), sz);
+            memset(ptrs[i], (int)i, sz);
+         }
+         for (size_t i = 1; i < count; i += 2) {
+            const size_t sz = 1 + (i * 97) % 1500;
+            for (size_t j = 0; j < sz; ++j)
+               eosio::check(ptrs[i][j] == (char)i, "freed memory overlapped a live allocation");
+         }
+      }
+
       [[eosio::action]]
       void mallocfail() {
          malloc(max_heap);
@@ -485,6 +485,7 @@ class Thread {
 
   void Reset();
   Index NumValues() const { return value_stack_top_; }
+  Index NumCalls() const { return call_stack_top_; }
   Result Push(Value) WABT_WARN_UNUSED;
   Value Pop();
   Value ValueAt(Index at) const;
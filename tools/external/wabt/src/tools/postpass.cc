@@ -18,13 +18,18 @@
 #include <cinttypes>
 #include <cstdio>
 #include <cstdlib>
+#include <functional>
 #include <iostream>
+#include <memory>
+#include <vector>
 
 #include "src/apply-names.h"
 #include "src/binary-reader.h"
 #include "src/binary-writer.h"
 #include "src/binary-reader-ir.h"
+#include "src/cast.h"
 #include "src/error-handler.h"
+#include "src/expr-visitor.h"
 #include "src/feature.h"
 #include "src/generate-names.h"
 #include "src/ir.h"
@@ -106,6 +111,94 @@ void StripZeroedData( Module& mod, size_t& fix_bytes ) {
    mod.data_segments = ds;
 }
 
+// A zero run this long inside a segment costs about as much as the header of the extra segment that splitting the
+// segment there takes (memory index, i32.const offset, end and size), so longer runs are split off and shorter gaps
+// between neighbouring segments are filled in to merge them.
+static const uint32_t s_max_zero_run = 8;
+
+bool GetConstOffset( const DataSegment& ds, uint32_t& offset ) {
+   if (ds.offset.size() != 1 || ds.offset.front().type() != ExprType::Const)
+      return false;
+   const Const& c = cast<ConstExpr>(&ds.offset.front())->const_;
+   if (c.type != Type::I32)
+      return false;
+   offset = c.u32;
+   return true;
+}
+
+// The memory the segments leave behind at instantiation, from `base` on, applied in order like the engine does
+std::vector<uint8_t> MemoryImage( const std::vector<DataSegment*>& segments, uint32_t base, uint32_t end ) {
+   std::vector<uint8_t> image(end - base, 0);
+   for ( auto DS : segments ) {
+      uint32_t offset;
+      // empty segments may lie outside [base, end), they are not part of the range CompactData computes
+      if (DS->data.empty() || !GetConstOffset(*DS, offset))
+         continue;
+      std::copy(DS->data.begin(), DS->data.end(), image.begin() + (offset - base));
+   }
+   return image;
+}
+
+// Re-cuts the data segments along the non-zero parts of the memory image they initialize: long zero runs inside a
+// segment split it, leading and trailing zeros are dropped and segments separated by short gaps are merged.  The
+// result is checked to initialize exactly the same memory, otherwise the segments are left as they were.
+bool CompactData( Module& mod, std::vector<std::unique_ptr<DataSegment>>& storage, size_t& fix_bytes ) {
+   uint64_t base = UINT32_MAX, end = 0;
+   size_t old_size = 0;
+   for ( auto DS : mod.data_segments ) {
+      uint32_t offset;
+      if (!GetConstOffset(*DS, offset) || DS->memory_var.index() != 0)
+         return false;
+      if (DS->data.empty())
+         continue;
+      base = std::min<uint64_t>(base, offset);
+      end  = std::max<uint64_t>(end, uint64_t(offset) + DS->data.size());
+      old_size += DS->data.size();
+   }
+   if (end == 0) {
+      mod.data_segments.clear();
+      fix_bytes += old_size;
+      return true;
+   }
+   if (end > UINT32_MAX)
+      return false;
+
+   const std::vector<uint8_t> image = MemoryImage(mod.data_segments, base, end);
+   std::vector<DataSegment*> ds;
+   size_t new_size = 0;
+   for (size_t i = 0; i < image.size();) {
+      if (image[i] == 0) {
+         i++;
+         continue;
+      }
+      size_t last = i; // last non-zero byte of the segment
+      for (size_t j = i + 1; j < image.size() && j - last <= s_max_zero_run; j++) {
+         if (image[j] != 0)
+            last = j;
+      }
+      storage.emplace_back(new DataSegment);
+      DataSegment* seg = storage.back().get();
+      seg->memory_var = Var(0);
+      seg->offset.push_back(MakeUnique<ConstExpr>(Const::I32(base + i)));
+      seg->data.assign(image.begin() + i, image.begin() + last + 1);
+      new_size += seg->data.size();
+      ds.push_back(seg);
+      i = last + 1;
+   }
+
+   if (MemoryImage(ds, base, end) != image)
+      return false;
+   if (s_log_stream) {
+      s_log_stream->Writef("data segments: %" PRIzd " with %" PRIzd " bytes compacted to %" PRIzd " with %" PRIzd " bytes\n",
+                           mod.data_segments.size(), old_size, ds.size(), new_size);
+   }
+   // merging fills the short gaps between segments with zeros, so the data can also grow
+   if (old_size > new_size)
+      fix_bytes += old_size - new_size;
+   mod.data_segments = ds;
+   return true;
+}
+
 void AddHeapPointerData( Module& mod, size_t fixup, const std::vector<uint8_t>& buff, DataSegment& ds ) {
    uint32_t heap_ptr  = ((GetHeapPtr(mod, buff)) + 7) & ~7; // align to 8 bytes
    Const c;
@@ -124,6 +217,120 @@ void AddHeapPointerData( Module& mod, size_t fixup, const std::vector<uint8_t>&
 void construct_apply( Module& mod ) {
 }
 
+// Hands every function and global reference in the module to the callbacks, function bodies through `on_body`
+class ReferenceVisitor : public ExprVisitor::DelegateNop {
+   public:
+      typedef std::function<void(Var&)> VarCallback;
+
+      ReferenceVisitor( VarCallback on_func, VarCallback on_global )
+         : on_func(on_func), on_global(on_global) {}
+
+      Result OnCallExpr(CallExpr* expr) override { on_func(expr->var); return Result::Ok; }
+      Result OnGetGlobalExpr(GetGlobalExpr* expr) override { on_global(expr->var); return Result::Ok; }
+      Result OnSetGlobalExpr(SetGlobalExpr* expr) override { on_global(expr->var); return Result::Ok; }
+
+      void VisitBody( ExprList& exprs ) {
+         ExprVisitor visitor(this);
+         visitor.VisitExprList(exprs);
+      }
+
+      // everything outside of the function bodies: exports, start, element and data segments and global initializers
+      void VisitModuleRefs( Module& mod ) {
+         for ( auto exp : mod.exports ) {
+            if (exp->kind == ExternalKind::Func)
+               on_func(exp->var);
+            else if (exp->kind == ExternalKind::Global)
+               on_global(exp->var);
+         }
+         for ( auto start : mod.starts )
+            on_func(*start);
+         for ( auto es : mod.elem_segments ) {
+            VisitBody(es->offset);
+            for ( auto& var : es->vars )
+               on_func(var);
+         }
+         for ( auto ds : mod.data_segments )
+            VisitBody(ds->offset);
+         for ( auto global : mod.globals )
+            VisitBody(global->init_expr);
+      }
+
+   private:
+      VarCallback on_func;
+      VarCallback on_global;
+};
+
+// Drops the defined functions and globals that are unreachable from the exports (apply among them), the start
+// function and the element segments, i.e. from everything the host or call_indirect can enter, and renumbers the
+// references to those that are kept.  Imports are left alone.
+void EliminateDeadCode( Module& mod ) {
+   std::vector<bool> live_funcs(mod.funcs.size()), live_globals(mod.globals.size());
+   std::vector<Index> worklist;
+   bool by_index = true;
+
+   ReferenceVisitor marker(
+      [&](Var& var) {
+         if (!var.is_index() || var.index() >= live_funcs.size()) {
+            by_index = false;
+         } else if (!live_funcs[var.index()]) {
+            live_funcs[var.index()] = true;
+            worklist.push_back(var.index());
+         }
+      },
+      [&](Var& var) {
+         if (!var.is_index() || var.index() >= live_globals.size())
+            by_index = false;
+         else
+            live_globals[var.index()] = true;
+      });
+
+   for ( Index i = 0; i < mod.num_func_imports; i++ )
+      live_funcs[i] = true;
+   for ( Index i = 0; i < mod.num_global_imports; i++ )
+      live_globals[i] = true;
+   marker.VisitModuleRefs(mod);
+   while (!worklist.empty()) {
+      Index func = worklist.back();
+      worklist.pop_back();
+      if (func >= mod.num_func_imports)
+         marker.VisitBody(mod.funcs[func]->exprs);
+   }
+   // modules read with their names refer to them by name, leave those be
+   if (!by_index)
+      return;
+
+   std::vector<Index> func_map(mod.funcs.size(), kInvalidIndex), global_map(mod.globals.size(), kInvalidIndex);
+   std::vector<Func*> funcs;
+   std::vector<Global*> globals;
+   for ( Index i = 0; i < mod.funcs.size(); i++ ) {
+      if (live_funcs[i]) {
+         func_map[i] = funcs.size();
+         funcs.push_back(mod.funcs[i]);
+      }
+   }
+   for ( Index i = 0; i < mod.globals.size(); i++ ) {
+      if (live_globals[i]) {
+         global_map[i] = globals.size();
+         globals.push_back(mod.globals[i]);
+      }
+   }
+
+   if (s_log_stream) {
+      s_log_stream->Writef("dead code: removed %" PRIzd " of %" PRIzd " functions and %" PRIzd " of %" PRIzd " globals\n",
+                           mod.funcs.size() - funcs.size(), mod.funcs.size() - mod.num_func_imports,
+                           mod.globals.size() - globals.size(), mod.globals.size() - mod.num_global_imports);
+   }
+
+   ReferenceVisitor renumber(
+      [&](Var& var) { var.set_index(func_map[var.index()]); },
+      [&](Var& var) { var.set_index(global_map[var.index()]); });
+   renumber.VisitModuleRefs(mod);
+   for ( auto func : funcs )
+      renumber.VisitBody(func->exprs);
+   mod.funcs   = funcs;
+   mod.globals = globals;
+}
+
 void WriteBufferToFile(string_view filename,
                        const OutputBuffer& buffer) {
   buffer.WriteToFile(filename);
@@ -140,6 +347,7 @@ int ProgramMain(int argc, char** argv) {
   std::unique_ptr<FileStream> s_log_stream_s;
   result = ReadFile(s_infile.c_str(), &file_data);
   DataSegment _hds;
+  std::vector<std::unique_ptr<DataSegment>> _data_segments;
   if (Succeeded(result)) {
     ErrorHandlerFile error_handler(Location::Type::Binary);
     Module module;
@@ -152,8 +360,11 @@ int ProgramMain(int argc, char** argv) {
 
     if (Succeeded(result)) {
       size_t fixup = 0;
-      StripZeroedData(module, fixup);
+      // segments with computed offsets can only be dropped when they are all zeros
+      if (!CompactData(module, _data_segments, fixup))
+         StripZeroedData(module, fixup);
       AddHeapPointerData(module, fixup, file_data, _hds);
+      EliminateDeadCode(module);
      if (Succeeded(result)) {
       MemoryStream stream(s_log_stream.get());
       result =
@@ -0,0 +1,500 @@
+/*
+ * Copyright 2016 WebAssembly Community Group participants
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "src/binary-reader-ir.h"
+#include "src/binary-reader.h"
+#include "src/cast.h"
+#include "src/error-handler.h"
+#include "src/ir.h"
+#include "src/option-parser.h"
+#include "src/stream.h"
+
+using namespace wabt;
+
+static std::string s_infile;
+static const char* s_outfile;
+static uint64_t s_max_instructions = 0;
+static uint64_t s_max_call_depth = 0;
+static uint64_t s_max_stack = 0;
+
+static const char s_description[] =
+R"(  Statically estimate what each action of a contract may cost.  Starting
+  from every __eosio_action_* and __eosio_notify_* dispatcher that codegen
+  generates (or from apply when the name section is stripped), the call
+  graph is walked to report:
+
+    - an instruction estimate: the longest path through each function,
+      taking every call and counting each loop body once,
+    - the deepest call chain and the shadow stack its frames take,
+    - the host functions that can be reached,
+    - the loops whose trip count is not a constant, and recursion.
+
+  Exits with an error when an action goes over one of the given limits.
+
+examples:
+  # report every action of hello.wasm
+  $ eosio-wasm-budget hello.wasm
+
+  # fail the build when an action may need more than 8 KiB of stack
+  $ eosio-wasm-budget --max-stack=8192 hello.wasm
+)";
+
+static void ParseOptions(int argc, char** argv) {
+  OptionParser parser("eosio-wasm-budget", s_description);
+
+  parser.AddOption('h', "help", "Print this help message", [&parser]() {
+    parser.PrintHelp();
+    exit(0);
+  });
+  parser.AddOption('o', "output", "FILENAME",
+                   "Output file for the report, by default use stdout",
+                   [](const char* argument) { s_outfile = argument; });
+  parser.AddOption('i', "max-instructions", "N",
+                   "Fail if an action's instruction estimate exceeds N",
+                   [](const char* argument) {
+                     s_max_instructions = strtoull(argument, nullptr, 10);
+                   });
+  parser.AddOption('d', "max-call-depth", "N",
+                   "Fail if an action's call chain is deeper than N",
+                   [](const char* argument) {
+                     s_max_call_depth = strtoull(argument, nullptr, 10);
+                   });
+  parser.AddOption('s', "max-stack", "N",
+                   "Fail if an action's stack frames exceed N bytes",
+                   [](const char* argument) {
+                     s_max_stack = strtoull(argument, nullptr, 10);
+                   });
+  parser.AddArgument("filename", OptionParser::ArgumentCount::One,
+                     [](const char* argument) {
+                       s_infile = argument;
+                       ConvertBackslashToSlash(&s_infile);
+                     });
+  parser.Parse(argc, argv);
+}
+
+namespace {
+
+struct Budget {
+  uint64_t instructions = 0;
+  uint64_t call_depth = 0;
+  uint64_t stack = 0;
+  bool recursive = false;
+  bool indirect_calls = false;
+  std::set<Index> host_calls;
+  std::set<std::string> open_loops;
+};
+
+// Variables of a module read from a binary are indices whether or not its
+// names were read, and branch targets are relative label depths.
+class BudgetAnalyzer {
+ public:
+  explicit BudgetAnalyzer(const Module& module)
+      : module_(module), state_(module.funcs.size(), State::New),
+        budgets_(module.funcs.size()) {
+    for (const ElemSegment* segment : module.elem_segments) {
+      for (const Var& var : segment->vars) {
+        table_funcs_.insert(var.index());
+      }
+    }
+  }
+
+  const Budget& Analyze(Index func_index) {
+    Budget& budget = budgets_[func_index];
+    if (state_[func_index] != State::New) {
+      return budget;
+    }
+    state_[func_index] = State::Active;
+
+    const Func* func = module_.funcs[func_index];
+    Walk walk(func_index, &budget);
+    budget.instructions = WalkList(func->exprs, &walk);
+    budget.call_depth += 1;
+    budget.stack += FrameSize(*func);
+
+    state_[func_index] = State::Done;
+    return budget;
+  }
+
+  std::string GetFuncName(Index func_index) const {
+    const std::string& name = module_.funcs[func_index]->name;
+    if (!name.empty()) {
+      return name.substr(name[0] == '$' ? 1 : 0);
+    }
+    return "func[" + std::to_string(func_index) + "]";
+  }
+
+ private:
+  enum class State { New, Active, Done };
+
+  struct Label {
+    bool is_loop;
+    bool branched_to;
+  };
+
+  struct Walk {
+    Walk(Index func_index, Budget* budget)
+        : func_index(func_index), budget(budget) {}
+
+    Index func_index;
+    Budget* budget;
+    std::vector<Label> labels;
+    Index loops = 0;
+  };
+
+  uint64_t WalkBlock(const ExprList& exprs, bool is_loop, Walk* walk) {
+    walk->labels.push_back({is_loop, false});
+    uint64_t instructions = WalkList(exprs, walk);
+    bool branched_to = walk->labels.back().branched_to;
+    walk->labels.pop_back();
+
+    if (is_loop) {
+      Index ordinal = ++walk->loops;
+      if (branched_to && !IsCounted(exprs)) {
+        walk->budget->open_loops.insert(GetFuncName(walk->func_index) +
+                                        " loop " + std::to_string(ordinal));
+      }
+    }
+    return instructions;
+  }
+
+  void Branch(const Var& target, Walk* walk) {
+    Index depth = target.index();
+    if (depth < walk->labels.size()) {
+      walk->labels[walk->labels.size() - 1 - depth].branched_to = true;
+    }
+  }
+
+  uint64_t Call(Index func_index, Walk* walk) {
+    Budget* budget = walk->budget;
+    if (func_index < module_.num_func_imports) {
+      budget->host_calls.insert(func_index);
+      return 0;
+    }
+    if (func_index >= module_.funcs.size()) {
+      return 0;
+    }
+    if (state_[func_index] == State::Active) {
+      budget->recursive = true;
+      return 0;
+    }
+    const Budget& callee = Analyze(func_index);
+    budget->call_depth = std::max(budget->call_depth, callee.call_depth);
+    budget->stack = std::max(budget->stack, callee.stack);
+    budget->recursive |= callee.recursive;
+    budget->indirect_calls |= callee.indirect_calls;
+    budget->host_calls.insert(callee.host_calls.begin(),
+                              callee.host_calls.end());
+    budget->open_loops.insert(callee.open_loops.begin(),
+                              callee.open_loops.end());
+    return callee.instructions;
+  }
+
+  // Any function in the table with the expected signature may be the callee.
+  uint64_t CallIndirect(const CallIndirectExpr& expr, Walk* walk) {
+    walk->budget->indirect_calls = true;
+    Index type_index = module_.GetFuncTypeIndex(expr.decl);
+    uint64_t instructions = 0;
+    for (Index func_index : table_funcs_) {
+      if (func_index < module_.funcs.size() &&
+          module_.GetFuncTypeIndex(module_.funcs[func_index]->decl) ==
+              type_index) {
+        instructions = std::max(instructions, Call(func_index, walk));
+      }
+    }
+    return instructions;
+  }
+
+  uint64_t WalkList(const ExprList& exprs, Walk* walk) {
+    uint64_t instructions = 0;
+    for (const Expr& expr : exprs) {
+      ++instructions;
+      switch (expr.type()) {
+        case ExprType::Block:
+          instructions +=
+              WalkBlock(cast<BlockExpr>(&expr)->block.exprs, false, walk);
+          break;
+        case ExprType::Loop:
+          instructions +=
+              WalkBlock(cast<LoopExpr>(&expr)->block.exprs, true, walk);
+          break;
+        case ExprType::If: {
+          auto* if_ = cast<IfExpr>(&expr);
+          instructions += std::max(WalkBlock(if_->true_.exprs, false, walk),
+                                   WalkBlock(if_->false_, false, walk));
+          break;
+        }
+        case ExprType::IfExcept: {
+          auto* if_ = cast<IfExceptExpr>(&expr);
+          instructions += std::max(WalkBlock(if_->true_.exprs, false, walk),
+                                   WalkBlock(if_->false_, false, walk));
+          break;
+        }
+        case ExprType::Try: {
+          auto* try_ = cast<TryExpr>(&expr);
+          instructions += std::max(WalkBlock(try_->block.exprs, false, walk),
+                                   WalkBlock(try_->catch_, false, walk));
+          break;
+        }
+        case ExprType::Br:
+          Branch(cast<BrExpr>(&expr)->var, walk);
+          break;
+        case ExprType::BrIf:
+          Branch(cast<BrIfExpr>(&expr)->var, walk);
+          break;
+        case ExprType::BrTable: {
+          auto* br_table = cast<BrTableExpr>(&expr);
+          for (const Var& target : br_table->targets) {
+            Branch(target, walk);
+          }
+          Branch(br_table->default_target, walk);
+          break;
+        }
+        case ExprType::Call:
+          instructions += Call(cast<CallExpr>(&expr)->var.index(), walk);
+          break;
+        case ExprType::CallIndirect:
+          instructions += CallIndirect(*cast<CallIndirectExpr>(&expr), walk);
+          break;
+        default:
+          break;
+      }
+    }
+    return instructions;
+  }
+
+  static std::vector<const Expr*> Flatten(const ExprList& exprs) {
+    std::vector<const Expr*> flat;
+    for (const Expr& expr : exprs) {
+      flat.push_back(&expr);
+    }
+    return flat;
+  }
+
+  static bool IsConst(const Expr* expr) {
+    return expr->type() == ExprType::Const;
+  }
+
+  static bool IsLocal(const Expr* expr, Index* local) {
+    if (expr->type() == ExprType::GetLocal) {
+      *local = cast<GetLocalExpr>(expr)->var.index();
+      return true;
+    }
+    if (expr->type() == ExprType::TeeLocal) {
+      *local = cast<TeeLocalExpr>(expr)->var.index();
+      return true;
+    }
+    return false;
+  }
+
+  static bool IsStep(const Expr* expr) {
+    if (expr->type() != ExprType::Binary) {
+      return false;
+    }
+    Opcode opcode = cast<BinaryExpr>(expr)->opcode;
+    return opcode == Opcode::I32Add || opcode == Opcode::I32Sub ||
+           opcode == Opcode::I64Add || opcode == Opcode::I64Sub;
+  }
+
+  static bool Sets(const Expr* expr, Index local) {
+    return (expr->type() == ExprType::SetLocal &&
+            cast<SetLocalExpr>(expr)->var.index() == local) ||
+           (expr->type() == ExprType::TeeLocal &&
+            cast<TeeLocalExpr>(expr)->var.index() == local);
+  }
+
+  // A loop that ends in `br_if 0` on a local compared to a constant, where
+  // the local is stepped by a constant in the loop body, i.e.
+  //   (local.set $i (i32.add (local.get $i) (i32.const k)))
+  //   (br_if 0 (i32.lt_u (local.get $i) (i32.const N)))
+  // Anything else depends on the data it runs on.
+  static bool IsCounted(const ExprList& body) {
+    std::vector<const Expr*> flat = Flatten(body);
+    size_t n = flat.size();
+    if (n < 4 || flat[n - 1]->type() != ExprType::BrIf ||
+        cast<BrIfExpr>(flat[n - 1])->var.index() != 0 ||
+        flat[n - 2]->type() != ExprType::Compare) {
+      return false;
+    }
+    Index counter;
+    if (!((IsLocal(flat[n - 4], &counter) && IsConst(flat[n - 3])) ||
+          (IsConst(flat[n - 4]) && IsLocal(flat[n - 3], &counter)))) {
+      return false;
+    }
+    for (size_t i = 0; i + 3 < n; ++i) {
+      Index stepped;
+      if (IsLocal(flat[i], &stepped) && stepped == counter &&
+          IsConst(flat[i + 1]) && IsStep(flat[i + 2]) &&
+          Sets(flat[i + 3], counter)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // The fixed part of a function's frame on the shadow stack, from the
+  // prologue `(global.set $sp (i32.sub (global.get $sp) (i32.const N)))`.
+  // Global 0 is the stack pointer in the modules eosio-ld links.
+  uint64_t FrameSize(const Func& func) const {
+    if (module_.globals.empty() || !module_.globals[0]->mutable_ ||
+        module_.globals[0]->type != Type::I32) {
+      return 0;
+    }
+    std::vector<const Expr*> flat = Flatten(func.exprs);
+    for (size_t i = 0; i + 2 < flat.size(); ++i) {
+      if (flat[i]->type() == ExprType::GetGlobal &&
+          cast<GetGlobalExpr>(flat[i])->var.index() == 0 &&
+          IsConst(flat[i + 1]) &&
+          flat[i + 2]->type() == ExprType::Binary &&
+          cast<BinaryExpr>(flat[i + 2])->opcode == Opcode::I32Sub) {
+        return cast<ConstExpr>(flat[i + 1])->const_.u32;
+      }
+    }
+    return 0;
+  }
+
+  const Module& module_;
+  std::vector<State> state_;
+  std::vector<Budget> budgets_;
+  std::set<Index> table_funcs_;
+};
+
+std::vector<Index> FindEntries(const Module& module) {
+  std::vector<Index> entries;
+  for (Index i = module.num_func_imports; i < module.funcs.size(); ++i) {
+    const std::string& name = module.funcs[i]->name;
+    if (name.compare(0, 16, "$__eosio_action_") == 0 ||
+        name.compare(0, 16, "$__eosio_notify_") == 0) {
+      entries.push_back(i);
+    }
+  }
+  if (entries.empty()) {
+    for (const Export* export_ : module.exports) {
+      if (export_->kind == ExternalKind::Func && export_->name == "apply") {
+        entries.push_back(export_->var.index());
+      }
+    }
+  }
+  return entries;
+}
+
+std::vector<std::string> GetImportNames(const Module& module) {
+  std::vector<std::string> names;
+  for (const Import* import : module.imports) {
+    if (import->kind() == ExternalKind::Func) {
+      names.push_back(import->field_name);
+    }
+  }
+  return names;
+}
+
+bool WriteBudget(Stream& stream,
+                 const std::string& name,
+                 const Budget& budget,
+                 const std::vector<std::string>& import_names) {
+  stream.Writef("%s\n", name.c_str());
+  stream.Writef("  instructions  %" PRIu64 "\n", budget.instructions);
+  stream.Writef("  call depth    %" PRIu64 "%s\n", budget.call_depth,
+                budget.recursive ? " (recursive)" : "");
+  stream.Writef("  stack         %" PRIu64 " bytes\n", budget.stack);
+  if (budget.indirect_calls) {
+    stream.Writef("  indirect      calls through the table\n");
+  }
+  stream.Writef("  host calls   ");
+  for (Index import : budget.host_calls) {
+    stream.Writef(" %s", import < import_names.size()
+                             ? import_names[import].c_str()
+                             : "?");
+  }
+  stream.Writef("\n");
+  for (const std::string& loop : budget.open_loops) {
+    stream.Writef("  open loop     %s\n", loop.c_str());
+  }
+  stream.Writef("\n");
+
+  bool within = true;
+  auto check = [&](uint64_t value, uint64_t limit, const char* what) {
+    if (limit && value > limit) {
+      fprintf(stderr,
+              "eosio-wasm-budget: %s: %s %" PRIu64 " exceeds %" PRIu64 "\n",
+              name.c_str(), what, value, limit);
+      within = false;
+    }
+  };
+  check(budget.instructions, s_max_instructions, "instruction estimate");
+  check(budget.call_depth, s_max_call_depth, "call depth");
+  check(budget.stack, s_max_stack, "stack");
+  return within;
+}
+
+}  // end anonymous namespace
+
+int ProgramMain(int argc, char** argv) {
+  InitStdio();
+  ParseOptions(argc, argv);
+
+  std::vector<uint8_t> file_data;
+  Result result = ReadFile(s_infile.c_str(), &file_data);
+  if (Failed(result)) {
+    return 1;
+  }
+
+  ErrorHandlerFile error_handler(Location::Type::Binary);
+  Module module;
+  const bool kReadDebugNames = true;
+  const bool kStopOnFirstError = true;
+  const bool kFailOnCustomSectionError = false;
+  ReadBinaryOptions options(Features(), nullptr, kReadDebugNames,
+                            kStopOnFirstError, kFailOnCustomSectionError);
+  result = ReadBinaryIr(s_infile.c_str(), file_data.data(), file_data.size(),
+                        &options, &error_handler, &module);
+  if (Failed(result)) {
+    return 1;
+  }
+
+  std::vector<Index> entries = FindEntries(module);
+  if (entries.empty()) {
+    fprintf(stderr, "eosio-wasm-budget: %s has no actions or apply\n",
+            s_infile.c_str());
+    return 1;
+  }
+
+  FileStream stream(s_outfile ? FileStream(s_outfile) : FileStream(stdout));
+  BudgetAnalyzer analyzer(module);
+  std::vector<std::string> import_names = GetImportNames(module);
+  bool within = true;
+  for (Index entry : entries) {
+    if (entry < module.num_func_imports || entry >= module.funcs.size()) {
+      continue;
+    }
+    within &= WriteBudget(stream, analyzer.GetFuncName(entry),
+                          analyzer.Analyze(entry), import_names);
+  }
+  return within ? 0 : 2;
+}
+
+int main(int argc, char** argv) {
+  WABT_TRY
+  return ProgramMain(argc, argv);
+  WABT_CATCH_BAD_ALLOC_AND_EXIT
+}
@@ -0,0 +1,2089 @@
+/*
+ * Copyright 2016 WebAssembly Community Group participants
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <array>
+#include <cinttypes>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <map>
+#include <memory>
+#include <set>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "src/binary-reader-interp.h"
+#include "src/binary-reader-nop.h"
+#include "src/binary-reader.h"
+#include "src/cast.h"
+#include "src/error-handler.h"
+#include "src/interp.h"
+#include "src/option-parser.h"
+#include "src/stream.h"
+
+using namespace wabt;
+using namespace wabt::interp;
+
+static const char* s_infile;
+static const char* s_outfile;
+static const char* s_script;
+static const char* s_save_state;
+static const char* s_flame;
+static std::string s_receiver;
+static std::string s_code;
+static std::string s_action;
+static std::string s_data;
+static const char* s_data_file;
+static size_t s_top = 20;
+static uint64_t s_max_instructions = 1000000000;
+static bool s_print;
+
+static const char s_description[] =
+R"(  Run contract actions in wabt's interpreter and profile them.  Host
+  functions are served from a local chain state: the primary and secondary
+  db indexes and the key-value database behave like they do on a node,
+  the rest (crypto, privileged, transaction) return zeros.  The state and
+  the actions to replay can be scripted, see below.
+
+  For each action the report holds its result, the host calls it made and
+  the functions it spent its instructions in, by self and total count.
+  The counts are interpreted instructions, so they are deterministic and
+  can be compared between builds; --flame writes the same samples as
+  folded stacks for flamegraph.pl or speedscope.
+
+  The script is a text file with one command per line, '#' starts a
+  comment; names are eosio names, keys and values hex:
+
+    row <code> <scope> <table> <primary> <payer> <value>
+    kv <contract> <key> <value>
+    auth <account>          only these accounts pass require_auth (default
+                            all of them do)
+    time <microseconds>     what current_time and publication_time return
+    return <import> <n>     what an import without a model returns
+    action <receiver> <code> <action> <data>
+
+examples:
+  # profile hello::hi with the serialized name "alice" as action data
+  $ eosio-profile hello.wasm -r hello -a hi -d 0000000000855c34
+
+  # replay the actions of a script and keep the resulting state
+  $ eosio-profile token.wasm -s transfers.txt --save-state after.txt
+
+  # flame graph of the same run
+  $ eosio-profile token.wasm -s transfers.txt --flame token.folded
+  $ flamegraph.pl token.folded > token.svg
+)";
+
+static void ParseOptions(int argc, char** argv) {
+  OptionParser parser("eosio-profile", s_description);
+
+  parser.AddOption('h', "help", "Print this help message", [&parser]() {
+    parser.PrintHelp();
+    exit(0);
+  });
+  parser.AddOption('o', "output", "FILENAME",
+                   "Output file for the report, by default use stdout",
+                   [](const char* argument) { s_outfile = argument; });
+  parser.AddOption('r', "receiver", "NAME", "Account the contract runs as",
+                   [](const char* argument) { s_receiver = argument; });
+  parser.AddOption('c', "code", "NAME",
+                   "Account the action belongs to, by default the receiver",
+                   [](const char* argument) { s_code = argument; });
+  parser.AddOption('a', "action", "NAME", "Name of the action to run",
+                   [](const char* argument) { s_action = argument; });
+  parser.AddOption('d', "data", "HEX", "Serialized action data",
+                   [](const char* argument) { s_data = argument; });
+  parser.AddOption('D', "data-file", "FILENAME",
+                   "Read the serialized action data from a binary file",
+                   [](const char* argument) { s_data_file = argument; });
+  parser.AddOption('s', "script", "FILENAME",
+                   "Load the chain state and actions from a script",
+                   [](const char* argument) { s_script = argument; });
+  parser.AddOption('S', "save-state", "FILENAME",
+                   "Write the chain state after the run as a script",
+                   [](const char* argument) { s_save_state = argument; });
+  parser.AddOption('f', "flame", "FILENAME",
+                   "Write the samples as folded stacks for flame graphs",
+                   [](const char* argument) { s_flame = argument; });
+  parser.AddOption(
+      'n', "top", "N",
+      "Number of functions to list, most expensive first; 0 lists all",
+      [](const char* argument) { s_top = strtoull(argument, nullptr, 10); });
+  parser.AddOption(
+      'm', "max-instructions", "N",
+      "Stop an action after N instructions (default 1000000000)",
+      [](const char* argument) {
+        s_max_instructions = strtoull(argument, nullptr, 10);
+      });
+  parser.AddOption('p', "print", "Include what the contract prints",
+                   []() { s_print = true; });
+  parser.AddArgument("filename", OptionParser::ArgumentCount::One,
+                     [](const char* argument) { s_infile = argument; });
+  parser.Parse(argc, argv);
+}
+
+namespace {
+
+typedef unsigned __int128 uint128;
+typedef std::array<uint128, 2> Key256;
+
+// The first error of the running host call; the call traps when it is set.
+std::string s_host_error;
+
+bool Check(bool condition, const std::string& message) {
+  if (!condition && s_host_error.empty()) {
+    s_host_error = message;
+  }
+  return condition;
+}
+
+uint64_t CharToSymbol(char c) {
+  if (c >= 'a' && c <= 'z') {
+    return c - 'a' + 6;
+  }
+  if (c >= '1' && c <= '5') {
+    return c - '1' + 1;
+  }
+  return 0;
+}
+
+bool StringToName(const std::string& str, uint64_t* out_value) {
+  if (str.size() > 13) {
+    return false;
+  }
+  uint64_t value = 0;
+  for (size_t i = 0; i < str.size(); ++i) {
+    char c = str[i];
+    if (c != '.' && CharToSymbol(c) == 0) {
+      return false;
+    }
+    if (i < 12) {
+      value |= (CharToSymbol(c) & 0x1f) << (64 - 5 * (i + 1));
+    } else if (CharToSymbol(c) > 0x0f) {
+      return false;
+    } else {
+      value |= CharToSymbol(c);
+    }
+  }
+  *out_value = value;
+  return true;
+}
+
+std::string NameToString(uint64_t value) {
+  static const char kCharmap[] = ".12345abcdefghijklmnopqrstuvwxyz";
+  std::string str(13, '.');
+  for (int i = 0; i <= 12; ++i) {
+    str[12 - i] = kCharmap[value & (i == 0 ? 0x0f : 0x1f)];
+    value >>= (i == 0 ? 4 : 5);
+  }
+  str.erase(str.find_last_not_of('.') + 1);
+  return str;
+}
+
+bool HexToBytes(const std::string& hex, std::string* out_bytes) {
+  std::string digits;
+  for (char c : hex) {
+    if (!isspace(static_cast<unsigned char>(c))) {
+      digits += c;
+    }
+  }
+  if (digits.size() % 2) {
+    return false;
+  }
+  out_bytes->clear();
+  for (size_t i = 0; i < digits.size(); i += 2) {
+    char* end;
+    std::string pair = digits.substr(i, 2);
+    long byte = strtol(pair.c_str(), &end, 16);
+    if (*end) {
+      return false;
+    }
+    out_bytes->push_back(static_cast<char>(byte));
+  }
+  return true;
+}
+
+std::string BytesToHex(const std::string& bytes) {
+  static const char kDigits[] = "0123456789abcdef";
+  std::string hex;
+  for (unsigned char c : bytes) {
+    hex += kDigits[c >> 4];
+    hex += kDigits[c & 0xf];
+  }
+  return hex.empty() ? "-" : hex;
+}
+
+struct TableId {
+  uint64_t code;
+  uint64_t scope;
+  uint64_t table;
+
+  bool operator<(const TableId& other) const {
+    return std::tie(code, scope, table) <
+           std::tie(other.code, other.scope, other.table);
+  }
+};
+
+struct NoExtra {};
+
+// TableSet, PrimaryIndex, SecondaryIndex and KvDatabase copy the chain state
+// of the native tester (libraries/native/chain_state.cpp), which wabt cannot
+// depend on.  Keep the two in sync: a change to the iterator handles, the
+// results or the checks there has to be made here as well.
+// tests/unit/profile_tests.sh and chain_state_profile_test make the same
+// calls through both and expect the same values.
+
+// The tables of one kind and the iterator handles handed out for them, with
+// the semantics of the native tester's chain state: a row keeps a single
+// handle however often it is looked up, and end iterators are -(n + 2) for
+// the n-th table created.
+template <typename Rows, typename Extra = NoExtra>
+class TableSet {
+ public:
+  typedef typename Rows::iterator RowIterator;
+
+  struct Table : Extra {
+    TableId id;
+    Rows rows;
+    int32_t end_itr;
+  };
+
+  // Tables without rows do not exist as far as the contract can tell.
+  Table* Find(uint64_t code, uint64_t scope, uint64_t table) {
+    auto it = tables_.find(TableId{code, scope, table});
+    return it == tables_.end() || it->second.rows.empty() ? nullptr
+                                                          : &it->second;
+  }
+
+  Table& FindOrCreate(uint64_t code, uint64_t scope, uint64_t table) {
+    TableId id{code, scope, table};
+    auto it = tables_.find(id);
+    if (it == tables_.end()) {
+      it = tables_.insert(std::make_pair(id, Table())).first;
+      it->second.id = id;
+      it->second.end_itr = -static_cast<int32_t>(ends_.size()) - 2;
+      ends_.push_back(id);
+    }
+    return it->second;
+  }
+
+  int32_t IteratorTo(Table& table, RowIterator row) {
+    if (row == table.rows.end()) {
+      return table.end_itr;
+    }
+    if (row->second.itr < 0) {
+      row->second.itr = rows_.size();
+      rows_.emplace_back(&table, row);
+    }
+    return row->second.itr;
+  }
+
+  // The table and row behind `itr`, or null if it does not point at a row.
+  Table* Get(int32_t itr, RowIterator* out_row) {
+    if (!Check(itr >= 0, "dereference of end iterator") ||
+        !Check(static_cast<size_t>(itr) < rows_.size(),
+               "dereference of invalid iterator") ||
+        !Check(rows_[itr].first != nullptr, "dereference of deleted object")) {
+      return nullptr;
+    }
+    *out_row = rows_[itr].second;
+    return rows_[itr].first;
+  }
+
+  Table* GetEnd(int32_t itr) {
+    if (!Check(itr < -1 && static_cast<size_t>(-(itr + 2)) < ends_.size(),
+               "invalid end iterator")) {
+      return nullptr;
+    }
+    return &tables_.find(ends_[-(itr + 2)])->second;
+  }
+
+  void Erase(int32_t itr) {
+    RowIterator row;
+    if (Table* table = Get(itr, &row)) {
+      rows_[itr].first = nullptr;
+      table->rows.erase(row);
+    }
+  }
+
+  // Moves the row behind `itr` to a new key, keeping its handle.
+  void Rekey(int32_t itr, const typename Rows::key_type& key) {
+    RowIterator row;
+    if (Table* table = Get(itr, &row)) {
+      typename Rows::mapped_type value = row->second;
+      table->rows.erase(row);
+      rows_[itr].second = table->rows.insert(std::make_pair(key, value)).first;
+    }
+  }
+
+  int32_t Next(int32_t itr) {
+    if (itr < -1) {
+      return -1;
+    }
+    RowIterator row;
+    Table* table = Get(itr, &row);
+    return table ? IteratorTo(*table, ++row) : -1;
+  }
+
+  int32_t Previous(int32_t itr) {
+    Table* table;
+    RowIterator row;
+    if (itr < -1) {
+      table = GetEnd(itr);
+      if (table) {
+        row = table->rows.end();
+      }
+    } else {
+      table = Get(itr, &row);
+    }
+    if (!table || row == table->rows.begin()) {
+      return -1;
+    }
+    return IteratorTo(*table, --row);
+  }
+
+  // Iterator handles only live as long as an action.
+  void ResetHandles() {
+    for (auto& handle : rows_) {
+      if (handle.first) {
+        handle.second->second.itr = -1;
+      }
+    }
+    rows_.clear();
+  }
+
+  std::map<TableId, Table>& tables() { return tables_; }
+
+ private:
+  std::map<TableId, Table> tables_;
+  std::vector<TableId> ends_;
+  std::vector<std::pair<Table*, RowIterator>> rows_;
+};
+
+class PrimaryIndex {
+ public:
+  struct Row {
+    std::string value;
+    uint64_t payer = 0;
+    int32_t itr = -1;
+  };
+
+  int32_t Store(uint64_t receiver, uint64_t scope, uint64_t table,
+                uint64_t payer, uint64_t id, const std::string& value) {
+    auto& t = set_.FindOrCreate(receiver, scope, table);
+    auto inserted = t.rows.insert(std::make_pair(id, Row()));
+    if (!Check(inserted.second,
+               "db_store_i64: a row with this primary key already exists")) {
+      return -1;
+    }
+    inserted.first->second.value = value;
+    inserted.first->second.payer = payer;
+    return set_.IteratorTo(t, inserted.first);
+  }
+
+  void Update(uint64_t receiver, int32_t itr, uint64_t payer,
+              const std::string& value) {
+    RowIterator row;
+    Table* t = set_.Get(itr, &row);
+    if (!t || !Check(t->id.code == receiver, "db access violation")) {
+      return;
+    }
+    row->second.value = value;
+    if (payer) {
+      row->second.payer = payer;
+    }
+  }
+
+  void Remove(uint64_t receiver, int32_t itr) {
+    RowIterator row;
+    Table* t = set_.Get(itr, &row);
+    if (t && Check(t->id.code == receiver, "db access violation")) {
+      set_.Erase(itr);
+    }
+  }
+
+  const std::string* Value(int32_t itr) {
+    RowIterator row;
+    return set_.Get(itr, &row) ? &row->second.value : nullptr;
+  }
+
+  int32_t Next(int32_t itr, uint64_t* primary) {
+    return WithPrimary(set_.Next(itr), primary);
+  }
+
+  int32_t Previous(int32_t itr, uint64_t* primary) {
+    return WithPrimary(set_.Previous(itr), primary);
+  }
+
+  int32_t Find(uint64_t code, uint64_t scope, uint64_t table, uint64_t id) {
+    auto t = set_.Find(code, scope, table);
+    return t ? set_.IteratorTo(*t, t->rows.find(id)) : -1;
+  }
+
+  int32_t LowerBound(uint64_t code, uint64_t scope, uint64_t table,
+                     uint64_t id) {
+    auto t = set_.Find(code, scope, table);
+    return t ? set_.IteratorTo(*t, t->rows.lower_bound(id)) : -1;
+  }
+
+  int32_t UpperBound(uint64_t code, uint64_t scope, uint64_t table,
+                     uint64_t id) {
+    auto t = set_.Find(code, scope, table);
+    return t ? set_.IteratorTo(*t, t->rows.upper_bound(id)) : -1;
+  }
+
+  int32_t End(uint64_t code, uint64_t scope, uint64_t table) {
+    auto t = set_.Find(code, scope, table);
+    return t ? t->end_itr : -1;
+  }
+
+  void ResetHandles() { set_.ResetHandles(); }
+
+  TableSet<std::map<uint64_t, Row>>& set() { return set_; }
+
+ private:
+  typedef TableSet<std::map<uint64_t, Row>> Set;
+  typedef Set::Table Table;
+  typedef Set::RowIterator RowIterator;
+
+  int32_t WithPrimary(int32_t itr, uint64_t* primary) {
+    RowIterator row;
+    if (itr >= 0 && set_.Get(itr, &row)) {
+      *primary = row->first;
+    }
+    return itr;
+  }
+
+  Set set_;
+};
+
+template <typename Secondary>
+struct ByPrimary {
+  std::map<uint64_t, Secondary> by_primary;
+};
+
+template <typename Secondary>
+class SecondaryIndex {
+ public:
+  int32_t Store(uint64_t receiver, uint64_t scope, uint64_t table,
+                uint64_t payer, uint64_t id, const Secondary& secondary) {
+    if (!CheckKey(secondary)) {
+      return -1;
+    }
+    auto& t = set_.FindOrCreate(receiver, scope, table);
+    if (!Check(t.by_primary.insert(std::make_pair(id, secondary)).second,
+               "secondary index already holds this primary key")) {
+      return -1;
+    }
+    auto row = t.rows.insert(std::make_pair(Key(secondary, id), Row())).first;
+    row->second.payer = payer;
+    return set_.IteratorTo(t, row);
+  }
+
+  void Update(uint64_t receiver, int32_t itr, uint64_t payer,
+              const Secondary& secondary) {
+    typename Set::RowIterator row;
+    auto t = set_.Get(itr, &row);
+    if (!CheckKey(secondary) || !t ||
+        !Check(t->id.code == receiver, "db access violation")) {
+      return;
+    }
+    const uint64_t primary = row->first.second;
+    if (payer) {
+      row->second.payer = payer;
+    }
+    t->by_primary[primary] = secondary;
+    set_.Rekey(itr, Key(secondary, primary));
+  }
+
+  void Remove(uint64_t receiver, int32_t itr) {
+    typename Set::RowIterator row;
+    auto t = set_.Get(itr, &row);
+    if (t && Check(t->id.code == receiver, "db access violation")) {
+      t->by_primary.erase(row->first.second);
+      set_.Erase(itr);
+    }
+  }
+
+  int32_t Next(int32_t itr, uint64_t* primary) {
+    return WithPrimary(set_.Next(itr), primary);
+  }
+
+  int32_t Previous(int32_t itr, uint64_t* primary) {
+    return WithPrimary(set_.Previous(itr), primary);
+  }
+
+  int32_t FindPrimary(uint64_t code, uint64_t scope, uint64_t table,
+                      Secondary* secondary, uint64_t primary) {
+    auto t = set_.Find(code, scope, table);
+    if (!t) {
+      return -1;
+    }
+    auto by_primary = t->by_primary.find(primary);
+    if (by_primary == t->by_primary.end()) {
+      return t->end_itr;
+    }
+    *secondary = by_primary->second;
+    return set_.IteratorTo(*t, t->rows.find(Key(*secondary, primary)));
+  }
+
+  int32_t FindSecondary(uint64_t code, uint64_t scope, uint64_t table,
+                        const Secondary& secondary, uint64_t* primary) {
+    auto t = set_.Find(code, scope, table);
+    if (!t) {
+      return -1;
+    }
+    auto row = t->rows.lower_bound(Key(secondary, 0));
+    if (row == t->rows.end() || secondary < row->first.first) {
+      return t->end_itr;
+    }
+    *primary = row->first.second;
+    return set_.IteratorTo(*t, row);
+  }
+
+  int32_t LowerBound(uint64_t code, uint64_t scope, uint64_t table,
+                     Secondary* secondary, uint64_t* primary) {
+    auto t = set_.Find(code, scope, table);
+    return t ? At(*t, t->rows.lower_bound(Key(*secondary, 0)), secondary,
+                  primary)
+             : -1;
+  }
+
+  int32_t UpperBound(uint64_t code, uint64_t scope, uint64_t table,
+                     Secondary* secondary, uint64_t* primary) {
+    auto t = set_.Find(code, scope, table);
+    Key key(*secondary, std::numeric_limits<uint64_t>::max());
+    return t ? At(*t, t->rows.upper_bound(key), secondary, primary) : -1;
+  }
+
+  int32_t End(uint64_t code, uint64_t scope, uint64_t table) {
+    auto t = set_.Find(code, scope, table);
+    return t ? t->end_itr : -1;
+  }
+
+  void ResetHandles() { set_.ResetHandles(); }
+
+ private:
+  typedef std::pair<Secondary, uint64_t> Key;
+
+  struct Row {
+    uint64_t payer = 0;
+    int32_t itr = -1;
+  };
+
+  typedef TableSet<std::map<Key, Row>, ByPrimary<Secondary>> Set;
+
+  static bool CheckKey(const Secondary& secondary) {
+    return Check(secondary == secondary,
+          "NaN is not an allowed value for a secondary key");
+  }
+
+  int32_t At(typename Set::Table& t,
+             typename Set::RowIterator row,
+             Secondary* secondary,
+             uint64_t* primary) {
+    if (row != t.rows.end()) {
+      *secondary = row->first.first;
+      *primary = row->first.second;
+    }
+    return set_.IteratorTo(t, row);
+  }
+
+  int32_t WithPrimary(int32_t itr, uint64_t* primary) {
+    typename Set::RowIterator row;
+    if (itr >= 0 && set_.Get(itr, &row)) {
+      *primary = row->first.second;
+    }
+    return itr;
+  }
+
+  Set set_;
+};
+
+// One ordered byte map per contract.  Iterators remember the key they are
+// positioned at, which lets them report that their pair was erased the way
+// nodeos does.
+class KvDatabase {
+ public:
+  static const int32_t kIteratorOk = 0;
+  static const int32_t kIteratorErased = -1;
+  static const int32_t kIteratorEnd = -2;
+
+  typedef std::map<std::string, std::string> Database;
+
+  int64_t Erase(uint64_t receiver, uint64_t contract, const std::string& key) {
+    if (!Check(contract == receiver, "Can not write to this key")) {
+      return 0;
+    }
+    Database& db = dbs_[contract];
+    auto it = db.find(key);
+    if (it == db.end()) {
+      return 0;
+    }
+    const int64_t delta = -static_cast<int64_t>(it->first.size() +
+                                                it->second.size());
+    db.erase(it);
+    return delta;
+  }
+
+  int64_t Set(uint64_t receiver, uint64_t contract, const std::string& key,
+              const std::string& value) {
+    if (!Check(contract == receiver, "Can not write to this key")) {
+      return 0;
+    }
+    Database& db = dbs_[contract];
+    auto it = db.find(key);
+    int64_t delta;
+    if (it == db.end()) {
+      delta = key.size() + value.size();
+      db[key] = value;
+    } else {
+      delta = static_cast<int64_t>(value.size()) - it->second.size();
+      it->second = value;
+    }
+    return delta;
+  }
+
+  bool Get(uint64_t contract, const std::string& key, uint32_t* value_size) {
+    Database& db = dbs_[contract];
+    auto it = db.find(key);
+    if (it == db.end()) {
+      value_.clear();
+      *value_size = 0;
+      return false;
+    }
+    value_ = it->second;
+    *value_size = value_.size();
+    return true;
+  }
+
+  const std::string& value() const { return value_; }
+
+  // Handles start at 1, kv::table treats 0 as "no iterator".
+  uint32_t ItCreate(uint64_t contract, const std::string& prefix) {
+    uint32_t handle;
+    if (free_.empty()) {
+      iterators_.emplace_back();
+      handle = iterators_.size();
+    } else {
+      handle = free_.back();
+      free_.pop_back();
+    }
+    Iterator& it = iterators_[handle - 1];
+    it.live = true;
+    it.contract = contract;
+    it.prefix = prefix;
+    it.at_end = true;
+    it.key.clear();
+    return handle;
+  }
+
+  void ItDestroy(uint32_t itr) {
+    if (Iterator* it = GetIterator(itr)) {
+      it->live = false;
+      free_.push_back(itr);
+    }
+  }
+
+  int32_t ItStatus(uint32_t itr) {
+    Iterator* it = GetIterator(itr);
+    return it ? Status(*it) : kIteratorEnd;
+  }
+
+  int32_t ItCompare(uint32_t itr_a, uint32_t itr_b) {
+    Iterator* a = GetIterator(itr_a);
+    Iterator* b = GetIterator(itr_b);
+    if (!a || !b ||
+        !Check(a->contract == b->contract && a->prefix == b->prefix,
+               "Incompatible key-value iterators") ||
+        !CheckNotErased(*a) || !CheckNotErased(*b)) {
+      return 0;
+    }
+    if (a->at_end || b->at_end) {
+      return static_cast<int32_t>(a->at_end) - static_cast<int32_t>(b->at_end);
+    }
+    return Sign(a->key.compare(b->key));
+  }
+
+  int32_t ItKeyCompare(uint32_t itr, const std::string& key) {
+    Iterator* it = GetIterator(itr);
+    if (!it || !CheckNotErased(*it)) {
+      return 0;
+    }
+    if (it->at_end) {
+      return 1;
+    }
+    return Sign(it->key.compare(key));
+  }
+
+  int32_t ItMoveToEnd(uint32_t itr) {
+    if (Iterator* it = GetIterator(itr)) {
+      it->at_end = true;
+    }
+    return kIteratorEnd;
+  }
+
+  int32_t ItNext(uint32_t itr, uint32_t* key_size, uint32_t* value_size) {
+    Iterator* it = GetIterator(itr);
+    if (!it || !CheckNotErased(*it)) {
+      return kIteratorEnd;
+    }
+    Database& db = dbs_[it->contract];
+    return MoveTo(*it, it->at_end ? db.lower_bound(it->prefix)
+                                  : db.upper_bound(it->key),
+                  key_size, value_size);
+  }
+
+  int32_t ItPrev(uint32_t itr, uint32_t* key_size, uint32_t* value_size) {
+    Iterator* it = GetIterator(itr);
+    if (!it || !CheckNotErased(*it)) {
+      return kIteratorEnd;
+    }
+    Database& db = dbs_[it->contract];
+    auto pos =
+        it->at_end ? PrefixEnd(db, it->prefix) : db.lower_bound(it->key);
+    if (pos == db.begin()) {
+      return MoveTo(*it, db.end(), key_size, value_size);
+    }
+    return MoveTo(*it, --pos, key_size, value_size);
+  }
+
+  int32_t ItLowerBound(uint32_t itr, const std::string& key,
+                       uint32_t* key_size, uint32_t* value_size) {
+    Iterator* it = GetIterator(itr);
+    if (!it) {
+      return kIteratorEnd;
+    }
+    Database& db = dbs_[it->contract];
+    return MoveTo(*it, db.lower_bound(std::max(key, it->prefix)), key_size,
+                  value_size);
+  }
+
+  // The key or value the iterator is at, or null with the status to return.
+  const std::string* ItKey(uint32_t itr, int32_t* status) {
+    Iterator* it = GetIterator(itr);
+    *status = it ? Status(*it) : kIteratorEnd;
+    return *status == kIteratorOk ? &it->key : nullptr;
+  }
+
+  const std::string* ItValue(uint32_t itr, int32_t* status) {
+    Iterator* it = GetIterator(itr);
+    *status = it ? Status(*it) : kIteratorEnd;
+    return *status == kIteratorOk ? &dbs_[it->contract].find(it->key)->second
+                                  : nullptr;
+  }
+
+  // Iterator handles only live as long as an action.
+  void ResetHandles() {
+    iterators_.clear();
+    free_.clear();
+    value_.clear();
+  }
+
+  std::map<uint64_t, Database>& dbs() { return dbs_; }
+
+ private:
+  struct Iterator {
+    bool live = false;
+    uint64_t contract = 0;
+    std::string prefix;
+    bool at_end = true;
+    std::string key;
+  };
+
+  static int32_t Sign(int c) { return c < 0 ? -1 : c > 0 ? 1 : 0; }
+
+  static bool HasPrefix(const std::string& key, const std::string& prefix) {
+    return key.compare(0, prefix.size(), prefix) == 0;
+  }
+
+  // First key past every key that starts with `prefix`.
+  static Database::iterator PrefixEnd(Database& db, std::string prefix) {
+    while (!prefix.empty() && static_cast<unsigned char>(prefix.back()) == 0xff) {
+      prefix.pop_back();
+    }
+    if (prefix.empty()) {
+      return db.end();
+    }
+    ++prefix.back();
+    return db.lower_bound(prefix);
+  }
+
+  Iterator* GetIterator(uint32_t itr) {
+    if (!Check(itr > 0 && itr <= iterators_.size() && iterators_[itr - 1].live,
+               "Bad key-value iterator")) {
+      return nullptr;
+    }
+    return &iterators_[itr - 1];
+  }
+
+  int32_t Status(const Iterator& it) {
+    if (it.at_end) {
+      return kIteratorEnd;
+    }
+    const Database& db = dbs_[it.contract];
+    return db.find(it.key) == db.end() ? kIteratorErased : kIteratorOk;
+  }
+
+  bool CheckNotErased(const Iterator& it) {
+    return Check(Status(it) != kIteratorErased, "Iterator to erased element");
+  }
+
+  int32_t MoveTo(Iterator& it, Database::iterator pos, uint32_t* key_size,
+                 uint32_t* value_size) {
+    if (pos == dbs_[it.contract].end() || !HasPrefix(pos->first, it.prefix)) {
+      it.at_end = true;
+      *key_size = 0;
+      *value_size = 0;
+      return kIteratorEnd;
+    }
+    it.at_end = false;
+    it.key = pos->first;
+    *key_size = pos->first.size();
+    *value_size = pos->second.size();
+    return kIteratorOk;
+  }
+
+  std::map<uint64_t, Database> dbs_;
+  std::string value_;
+  std::vector<Iterator> iterators_;
+  std::vector<uint32_t> free_;
+};
+
+// Everything an action can write.  Copies are only taken between actions,
+// when no iterator handles are out.
+struct ChainState {
+  PrimaryIndex primary;
+  SecondaryIndex<uint64_t> idx64;
+  SecondaryIndex<uint128> idx128;
+  SecondaryIndex<Key256> idx256;
+  SecondaryIndex<double> idx_double;
+  KvDatabase kv;
+
+  void ResetHandles() {
+    primary.ResetHandles();
+    idx64.ResetHandles();
+    idx128.ResetHandles();
+    idx256.ResetHandles();
+    idx_double.ResetHandles();
+    kv.ResetHandles();
+  }
+};
+
+struct ActionRun {
+  uint64_t receiver = 0;
+  uint64_t code = 0;
+  uint64_t action = 0;
+  std::string data;
+};
+
+class Host;
+
+// Arguments and results of one host call, pointers are checked against the
+// linear memory of the running instance.
+class HostCall {
+ public:
+  HostCall(Host* host, const interp::FuncSignature* sig, TypedValue* args,
+           TypedValue* results)
+      : host_(host), sig_(sig), args_(args), results_(results) {}
+
+  uint32_t U32(Index i) const { return args_[i].value.i32; }
+  uint64_t U64(Index i) const { return args_[i].value.i64; }
+  double F64(Index i) const {
+    double value;
+    memcpy(&value, &args_[i].value.f64_bits, sizeof(value));
+    return value;
+  }
+  float F32(Index i) const {
+    float value;
+    memcpy(&value, &args_[i].value.f32_bits, sizeof(value));
+    return value;
+  }
+
+  char* Ptr(Index i, uint64_t size) const;
+  std::string Bytes(Index ptr, Index size) const {
+    return std::string(Ptr(ptr, U32(size)), U32(size));
+  }
+  std::string CString(Index i) const;
+
+  template <typename T>
+  T Load(Index i) const {
+    T value;
+    memcpy(&value, Ptr(i, sizeof(T)), sizeof(T));
+    return value;
+  }
+
+  template <typename T>
+  void Store(Index i, const T& value) const {
+    memcpy(Ptr(i, sizeof(T)), &value, sizeof(T));
+  }
+
+  void Return(uint64_t value) const {
+    if (sig_->result_types.empty()) {
+      return;
+    }
+    if (sig_->result_types[0] == Type::I32) {
+      results_[0].value.i32 = static_cast<uint32_t>(value);
+    } else {
+      results_[0].value.i64 = value;
+    }
+  }
+
+  Host* host() const { return host_; }
+
+ private:
+  Host* host_;
+  const interp::FuncSignature* sig_;
+  TypedValue* args_;
+  TypedValue* results_;
+};
+
+// The chain as the contract sees it: persistent state shared by every
+// action of a run, and the context of the action that currently runs.
+class Host {
+ public:
+  typedef std::function<void(const HostCall&)> Handler;
+
+  struct Binding {
+    Host* host;
+    std::string name;
+    const Handler* handler;
+  };
+
+  Host() { DefineHandlers(); }
+
+  // Attaches an import of a freshly read module to its handler.
+  void Bind(interp::HostFunc* func) {
+    auto handler = handlers_.find(func->field_name);
+    if (handler == handlers_.end()) {
+      unmodelled_.insert(func->field_name);
+    }
+    bindings_.emplace_back(new Binding{
+        this, func->field_name,
+        handler == handlers_.end() ? nullptr : &handler->second});
+    func->callback = Callback;
+    func->user_data = bindings_.back().get();
+  }
+
+  void BeginAction(const ActionRun& run, interp::Memory* memory) {
+    run_ = run;
+    memory_ = memory;
+    prints_.clear();
+    error_.clear();
+    exited_ = false;
+    inline_actions_ = 0;
+    notified_.clear();
+    host_calls_.clear();
+    state_.ResetHandles();
+    saved_state_ = state_;
+  }
+
+  // Drops the writes of an action that failed.
+  void RevertAction() { state_ = saved_state_; }
+
+  // Out of bounds accesses fail the call and go to a scratch buffer, so
+  // the handler can finish without checking every pointer itself.
+  char* Memory(uint32_t ptr, uint64_t size) {
+    if (!Check(memory_ && ptr + size <= memory_->data.size(),
+               "access violation")) {
+      scratch_.assign(std::max<uint64_t>(size, 1), 0);
+      return scratch_.data();
+    }
+    return memory_->data.data() + ptr;
+  }
+
+  const std::string& prints() const { return prints_; }
+  const std::string& error() const { return error_; }
+  bool exited() const { return exited_; }
+  uint32_t inline_actions() const { return inline_actions_; }
+  const std::vector<uint64_t>& notified() const { return notified_; }
+  const std::map<std::string, uint64_t>& host_calls() const {
+    return host_calls_;
+  }
+  const std::set<std::string>& unmodelled() const { return unmodelled_; }
+
+  bool LoadScript(const char* filename, std::vector<ActionRun>* actions);
+  void SaveState(Stream& stream);
+
+ private:
+  static interp::Result Callback(const interp::HostFunc* func,
+                                 const interp::FuncSignature* sig,
+                                 Index num_args,
+                                 TypedValue* args,
+                                 Index num_results,
+                                 TypedValue* out_results,
+                                 void* user_data) {
+    Binding* binding = static_cast<Binding*>(user_data);
+    Host* host = binding->host;
+    for (Index i = 0; i < num_results; ++i) {
+      out_results[i].type = sig->result_types[i];
+      out_results[i].value.i64 = 0;
+    }
+    ++host->host_calls_[binding->name];
+    HostCall call(host, sig, args, out_results);
+    if (!binding->handler) {
+      // Imports without a model return what the script says, or zero.
+      auto value = host->returns_.find(binding->name);
+      if (value != host->returns_.end()) {
+        call.Return(value->second);
+      }
+      return interp::Result::Ok;
+    }
+    s_host_error.clear();
+    (*binding->handler)(call);
+    if (!s_host_error.empty()) {
+      host->error_ = s_host_error;
+      return interp::Result::TrapHostTrapped;
+    }
+    return interp::Result::Ok;
+  }
+
+  void Print(const std::string& str) { prints_ += str; }
+
+  void DefineHandlers();
+  void DefineDbHandlers();
+  void DefineKvHandlers();
+
+  template <typename Secondary>
+  void DefineSecondaryHandlers(const std::string& prefix,
+                               SecondaryIndex<Secondary>* index);
+  void DefineIdx256Handlers();
+
+  std::map<std::string, Handler> handlers_;
+  std::vector<std::unique_ptr<Binding>> bindings_;
+  std::set<std::string> unmodelled_;
+  std::map<std::string, uint64_t> returns_;
+
+  ChainState state_;
+  ChainState saved_state_;
+  std::set<uint64_t> auths_;
+  uint64_t time_ = 0;
+
+  ActionRun run_;
+  interp::Memory* memory_ = nullptr;
+  std::vector<char> scratch_;
+  std::string prints_;
+  std::string error_;
+  bool exited_ = false;
+  uint32_t inline_actions_ = 0;
+  std::vector<uint64_t> notified_;
+  std::map<std::string, uint64_t> host_calls_;
+};
+
+char* HostCall::Ptr(Index i, uint64_t size) const {
+  return host_->Memory(U32(i), size);
+}
+
+std::string HostCall::CString(Index i) const {
+  uint32_t ptr = U32(i);
+  std::string str;
+  for (;; ++ptr) {
+    char c = *host_->Memory(ptr, 1);
+    if (!c) {
+      return str;
+    }
+    str += c;
+  }
+}
+
+void Host::DefineHandlers() {
+  auto& h = handlers_;
+  h["action_data_size"] = [this](const HostCall& call) {
+    call.Return(run_.data.size());
+  };
+  h["read_action_data"] = [this](const HostCall& call) {
+    uint32_t size = call.U32(1);
+    if (size == 0) {
+      call.Return(run_.data.size());
+      return;
+    }
+    size = std::min<size_t>(size, run_.data.size());
+    memcpy(call.Ptr(0, size), run_.data.data(), size);
+    call.Return(size);
+  };
+  h["current_receiver"] = [this](const HostCall& call) {
+    call.Return(run_.receiver);
+  };
+  h["get_sender"] = [](const HostCall& call) { call.Return(0); };
+  h["require_recipient"] = [this](const HostCall& call) {
+    notified_.push_back(call.U64(0));
+  };
+  auto has_auth = [this](uint64_t account) {
+    return auths_.empty() || auths_.count(account) != 0;
+  };
+  h["require_auth"] = [has_auth](const HostCall& call) {
+    Check(has_auth(call.U64(0)),
+          "missing authority of " + NameToString(call.U64(0)));
+  };
+  h["require_auth2"] = h["require_auth"];
+  h["has_auth"] = [has_auth](const HostCall& call) {
+    call.Return(has_auth(call.U64(0)));
+  };
+  h["is_account"] = [](const HostCall& call) { call.Return(1); };
+  h["send_inline"] = [this](const HostCall& call) {
+    call.Ptr(0, call.U32(1));
+    ++inline_actions_;
+  };
+  h["send_context_free_inline"] = h["send_inline"];
+  h["set_action_return_value"] = [](const HostCall& call) {
+    call.Ptr(0, call.U32(1));
+  };
+  h["current_time"] = [this](const HostCall& call) { call.Return(time_); };
+  h["publication_time"] = h["current_time"];
+  h["is_feature_activated"] = [](const HostCall& call) { call.Return(1); };
+
+  h["eosio_assert"] = [](const HostCall& call) {
+    if (!call.U32(0)) {
+      Check(false, "assertion failure with message: " + call.CString(1));
+    }
+  };
+  h["eosio_assert_message"] = [](const HostCall& call) {
+    if (!call.U32(0)) {
+      Check(false, "assertion failure with message: " + call.Bytes(1, 2));
+    }
+  };
+  h["eosio_assert_code"] = [](const HostCall& call) {
+    if (!call.U32(0)) {
+      Check(false,
+            "assertion failure with error code: " + std::to_string(call.U64(1)));
+    }
+  };
+  h["eosio_exit"] = [this](const HostCall&) {
+    exited_ = true;
+    Check(false, "eosio_exit");
+  };
+  h["abort"] = [](const HostCall&) { Check(false, "abort() called"); };
+
+  h["prints"] = [this](const HostCall& call) { Print(call.CString(0)); };
+  h["prints_l"] = [this](const HostCall& call) { Print(call.Bytes(0, 1)); };
+  h["printi"] = [this](const HostCall& call) {
+    Print(std::to_string(static_cast<int64_t>(call.U64(0))));
+  };
+  h["printui"] = [this](const HostCall& call) {
+    Print(std::to_string(call.U64(0)));
+  };
+  h["printn"] = [this](const HostCall& call) {
+    Print(NameToString(call.U64(0)));
+  };
+  h["printsf"] = [this](const HostCall& call) {
+    Print(std::to_string(call.F32(0)));
+  };
+  h["printdf"] = [this](const HostCall& call) {
+    Print(std::to_string(call.F64(0)));
+  };
+  h["printhex"] = [this](const HostCall& call) {
+    Print(BytesToHex(call.Bytes(0, 1)));
+  };
+
+  DefineDbHandlers();
+  DefineKvHandlers();
+}
+
+void Host::DefineDbHandlers() {
+  auto& h = handlers_;
+  h["db_store_i64"] = [this](const HostCall& call) {
+    call.Return(state_.primary.Store(run_.receiver, call.U64(0), call.U64(1),
+                               call.U64(2), call.U64(3), call.Bytes(4, 5)));
+  };
+  h["db_update_i64"] = [this](const HostCall& call) {
+    state_.primary.Update(run_.receiver, call.U32(0), call.U64(1),
+                    call.Bytes(2, 3));
+  };
+  h["db_remove_i64"] = [this](const HostCall& call) {
+    state_.primary.Remove(run_.receiver, call.U32(0));
+  };
+  h["db_get_i64"] = [this](const HostCall& call) {
+    const std::string* value = state_.primary.Value(call.U32(0));
+    uint32_t size = call.U32(2);
+    if (!value || size == 0) {
+      call.Return(value ? value->size() : 0);
+      return;
+    }
+    size = std::min<size_t>(size, value->size());
+    memcpy(call.Ptr(1, size), value->data(), size);
+    call.Return(size);
+  };
+  h["db_next_i64"] = [this](const HostCall& call) {
+    uint64_t primary = call.Load<uint64_t>(1);
+    call.Return(state_.primary.Next(call.U32(0), &primary));
+    call.Store(1, primary);
+  };
+  h["db_previous_i64"] = [this](const HostCall& call) {
+    uint64_t primary = call.Load<uint64_t>(1);
+    call.Return(state_.primary.Previous(call.U32(0), &primary));
+    call.Store(1, primary);
+  };
+  h["db_find_i64"] = [this](const HostCall& call) {
+    call.Return(state_.primary.Find(call.U64(0), call.U64(1), call.U64(2),
+                              call.U64(3)));
+  };
+  h["db_lowerbound_i64"] = [this](const HostCall& call) {
+    call.Return(state_.primary.LowerBound(call.U64(0), call.U64(1), call.U64(2),
+                                    call.U64(3)));
+  };
+  h["db_upperbound_i64"] = [this](const HostCall& call) {
+    call.Return(state_.primary.UpperBound(call.U64(0), call.U64(1), call.U64(2),
+                                    call.U64(3)));
+  };
+  h["db_end_i64"] = [this](const HostCall& call) {
+    call.Return(state_.primary.End(call.U64(0), call.U64(1), call.U64(2)));
+  };
+
+  DefineSecondaryHandlers("db_idx64_", &state_.idx64);
+  DefineSecondaryHandlers("db_idx128_", &state_.idx128);
+  DefineSecondaryHandlers("db_idx_double_", &state_.idx_double);
+  DefineIdx256Handlers();
+
+  // The host has no 128-bit float to order them by.
+  for (const char* suffix :
+       {"store", "update", "remove", "next", "previous", "find_primary",
+        "find_secondary", "lowerbound", "upperbound", "end"}) {
+    h[std::string("db_idx_long_double_") + suffix] = [](const HostCall&) {
+      Check(false, "db_idx_long_double_* is not supported by eosio-profile");
+    };
+  }
+}
+
+// idx64, idx128 and idx_double pass their key by pointer.
+template <typename Secondary>
+void Host::DefineSecondaryHandlers(const std::string& prefix,
+                                   SecondaryIndex<Secondary>* index) {
+  auto& h = handlers_;
+  h[prefix + "store"] = [this, index](const HostCall& call) {
+    call.Return(index->Store(run_.receiver, call.U64(0), call.U64(1),
+                             call.U64(2), call.U64(3),
+                             call.Load<Secondary>(4)));
+  };
+  h[prefix + "update"] = [this, index](const HostCall& call) {
+    index->Update(run_.receiver, call.U32(0), call.U64(1),
+                  call.Load<Secondary>(2));
+  };
+  h[prefix + "remove"] = [this, index](const HostCall& call) {
+    index->Remove(run_.receiver, call.U32(0));
+  };
+  h[prefix + "next"] = [index](const HostCall& call) {
+    uint64_t primary = call.Load<uint64_t>(1);
+    call.Return(index->Next(call.U32(0), &primary));
+    call.Store(1, primary);
+  };
+  h[prefix + "previous"] = [index](const HostCall& call) {
+    uint64_t primary = call.Load<uint64_t>(1);
+    call.Return(index->Previous(call.U32(0), &primary));
+    call.Store(1, primary);
+  };
+  h[prefix + "find_primary"] = [index](const HostCall& call) {
+    Secondary secondary = call.Load<Secondary>(3);
+    call.Return(index->FindPrimary(call.U64(0), call.U64(1), call.U64(2),
+                                   &secondary, call.U64(4)));
+    call.Store(3, secondary);
+  };
+  h[prefix + "find_secondary"] = [index](const HostCall& call) {
+    uint64_t primary = call.Load<uint64_t>(4);
+    call.Return(index->FindSecondary(call.U64(0), call.U64(1), call.U64(2),
+                                     call.Load<Secondary>(3), &primary));
+    call.Store(4, primary);
+  };
+  h[prefix + "lowerbound"] = [index](const HostCall& call) {
+    Secondary secondary = call.Load<Secondary>(3);
+    uint64_t primary = call.Load<uint64_t>(4);
+    call.Return(index->LowerBound(call.U64(0), call.U64(1), call.U64(2),
+                                  &secondary, &primary));
+    call.Store(3, secondary);
+    call.Store(4, primary);
+  };
+  h[prefix + "upperbound"] = [index](const HostCall& call) {
+    Secondary secondary = call.Load<Secondary>(3);
+    uint64_t primary = call.Load<uint64_t>(4);
+    call.Return(index->UpperBound(call.U64(0), call.U64(1), call.U64(2),
+                                  &secondary, &primary));
+    call.Store(3, secondary);
+    call.Store(4, primary);
+  };
+  h[prefix + "end"] = [index](const HostCall& call) {
+    call.Return(index->End(call.U64(0), call.U64(1), call.U64(2)));
+  };
+}
+
+// idx256 passes its key as a pointer and a count of 128-bit words, which
+// has to be 2; the remaining arguments shift by one.
+void Host::DefineIdx256Handlers() {
+  auto& h = handlers_;
+  auto key = [](const HostCall& call, Index ptr, Index size) {
+    Check(call.U32(size) == 2,
+          "invalid size of secondary key array for idx256");
+    return call.Load<Key256>(ptr);
+  };
+  h["db_idx256_store"] = [this, key](const HostCall& call) {
+    call.Return(state_.idx256.Store(run_.receiver, call.U64(0), call.U64(1),
+                              call.U64(2), call.U64(3), key(call, 4, 5)));
+  };
+  h["db_idx256_update"] = [this, key](const HostCall& call) {
+    state_.idx256.Update(run_.receiver, call.U32(0), call.U64(1), key(call, 2, 3));
+  };
+  h["db_idx256_remove"] = [this](const HostCall& call) {
+    state_.idx256.Remove(run_.receiver, call.U32(0));
+  };
+  h["db_idx256_next"] = [this](const HostCall& call) {
+    uint64_t primary = call.Load<uint64_t>(1);
+    call.Return(state_.idx256.Next(call.U32(0), &primary));
+    call.Store(1, primary);
+  };
+  h["db_idx256_previous"] = [this](const HostCall& call) {
+    uint64_t primary = call.Load<uint64_t>(1);
+    call.Return(state_.idx256.Previous(call.U32(0), &primary));
+    call.Store(1, primary);
+  };
+  h["db_idx256_find_primary"] = [this, key](const HostCall& call) {
+    Key256 secondary = key(call, 3, 4);
+    call.Return(state_.idx256.FindPrimary(call.U64(0), call.U64(1), call.U64(2),
+                                    &secondary, call.U64(5)));
+    call.Store(3, secondary);
+  };
+  h["db_idx256_find_secondary"] = [this, key](const HostCall& call) {
+    uint64_t primary = call.Load<uint64_t>(5);
+    call.Return(state_.idx256.FindSecondary(call.U64(0), call.U64(1), call.U64(2),
+                                      key(call, 3, 4), &primary));
+    call.Store(5, primary);
+  };
+  h["db_idx256_lowerbound"] = [this, key](const HostCall& call) {
+    Key256 secondary = key(call, 3, 4);
+    uint64_t primary = call.Load<uint64_t>(5);
+    call.Return(state_.idx256.LowerBound(call.U64(0), call.U64(1), call.U64(2),
+                                   &secondary, &primary));
+    call.Store(3, secondary);
+    call.Store(5, primary);
+  };
+  h["db_idx256_upperbound"] = [this, key](const HostCall& call) {
+    Key256 secondary = key(call, 3, 4);
+    uint64_t primary = call.Load<uint64_t>(5);
+    call.Return(state_.idx256.UpperBound(call.U64(0), call.U64(1), call.U64(2),
+                                   &secondary, &primary));
+    call.Store(3, secondary);
+    call.Store(5, primary);
+  };
+  h["db_idx256_end"] = [this](const HostCall& call) {
+    call.Return(state_.idx256.End(call.U64(0), call.U64(1), call.U64(2)));
+  };
+}
+
+void Host::DefineKvHandlers() {
+  auto& h = handlers_;
+  h["kv_erase"] = [this](const HostCall& call) {
+    call.Return(state_.kv.Erase(run_.receiver, call.U64(0), call.Bytes(1, 2)));
+  };
+  h["kv_set"] = [this](const HostCall& call) {
+    call.Return(state_.kv.Set(run_.receiver, call.U64(0), call.Bytes(1, 2),
+                        call.Bytes(3, 4)));
+  };
+  h["kv_get"] = [this](const HostCall& call) {
+    uint32_t value_size;
+    call.Return(state_.kv.Get(call.U64(0), call.Bytes(1, 2), &value_size));
+    call.Store(3, value_size);
+  };
+  h["kv_get_data"] = [this](const HostCall& call) {
+    const std::string& value = state_.kv.value();
+    uint32_t offset = call.U32(0);
+    if (offset < value.size()) {
+      size_t size = std::min<size_t>(call.U32(2), value.size() - offset);
+      memcpy(call.Ptr(1, size), value.data() + offset, size);
+    }
+    call.Return(value.size());
+  };
+  h["kv_it_create"] = [this](const HostCall& call) {
+    call.Return(state_.kv.ItCreate(call.U64(0), call.Bytes(1, 2)));
+  };
+  h["kv_it_destroy"] = [this](const HostCall& call) {
+    state_.kv.ItDestroy(call.U32(0));
+  };
+  h["kv_it_status"] = [this](const HostCall& call) {
+    call.Return(state_.kv.ItStatus(call.U32(0)));
+  };
+  h["kv_it_compare"] = [this](const HostCall& call) {
+    call.Return(state_.kv.ItCompare(call.U32(0), call.U32(1)));
+  };
+  h["kv_it_key_compare"] = [this](const HostCall& call) {
+    call.Return(state_.kv.ItKeyCompare(call.U32(0), call.Bytes(1, 2)));
+  };
+  h["kv_it_move_to_end"] = [this](const HostCall& call) {
+    call.Return(state_.kv.ItMoveToEnd(call.U32(0)));
+  };
+  h["kv_it_next"] = [this](const HostCall& call) {
+    uint32_t key_size, value_size;
+    call.Return(state_.kv.ItNext(call.U32(0), &key_size, &value_size));
+    call.Store(1, key_size);
+    call.Store(2, value_size);
+  };
+  h["kv_it_prev"] = [this](const HostCall& call) {
+    uint32_t key_size, value_size;
+    call.Return(state_.kv.ItPrev(call.U32(0), &key_size, &value_size));
+    call.Store(1, key_size);
+    call.Store(2, value_size);
+  };
+  h["kv_it_lower_bound"] = [this](const HostCall& call) {
+    uint32_t key_size, value_size;
+    call.Return(state_.kv.ItLowerBound(call.U32(0), call.Bytes(1, 2), &key_size,
+                                 &value_size));
+    call.Store(3, key_size);
+    call.Store(4, value_size);
+  };
+  // kv_it_key and kv_it_value copy from `offset` and report the full size.
+  auto copy_out = [](const HostCall& call, const std::string* src,
+                     int32_t status) {
+    uint32_t actual_size = 0;
+    if (src) {
+      uint32_t offset = call.U32(1);
+      if (offset < src->size() && call.U32(3) > 0) {
+        size_t size = std::min<size_t>(call.U32(3), src->size() - offset);
+        memcpy(call.Ptr(2, size), src->data() + offset, size);
+      }
+      actual_size = src->size();
+    }
+    call.Store(4, actual_size);
+    call.Return(status);
+  };
+  h["kv_it_key"] = [this, copy_out](const HostCall& call) {
+    int32_t status;
+    const std::string* key = state_.kv.ItKey(call.U32(0), &status);
+    copy_out(call, key, status);
+  };
+  h["kv_it_value"] = [this, copy_out](const HostCall& call) {
+    int32_t status;
+    const std::string* value = state_.kv.ItValue(call.U32(0), &status);
+    copy_out(call, value, status);
+  };
+}
+
+bool Host::LoadScript(const char* filename, std::vector<ActionRun>* actions) {
+  std::ifstream in(filename);
+  if (!in) {
+    fprintf(stderr, "eosio-profile: unable to read %s\n", filename);
+    return false;
+  }
+  std::string line;
+  for (int line_number = 1; std::getline(in, line); ++line_number) {
+    line = line.substr(0, line.find('#'));
+    std::istringstream tokens(line);
+    std::vector<std::string> args;
+    for (std::string token; tokens >> token;) {
+      args.push_back(token);
+    }
+    if (args.empty()) {
+      continue;
+    }
+
+    auto error = [&](const char* message) {
+      fprintf(stderr, "%s:%d: %s\n", filename, line_number, message);
+      return false;
+    };
+    auto name = [&](size_t i, uint64_t* value) {
+      return i < args.size() && StringToName(args[i], value);
+    };
+    auto number = [&](size_t i, uint64_t* value) {
+      if (i >= args.size()) {
+        return false;
+      }
+      char* end;
+      *value = strtoull(args[i].c_str(), &end, 10);
+      return *end == 0;
+    };
+    auto bytes = [&](size_t i, std::string* value) {
+      if (i >= args.size()) {
+        return false;
+      }
+      if (args[i] == "-") {
+        value->clear();
+        return true;
+      }
+      return HexToBytes(args[i], value);
+    };
+
+    const std::string& command = args[0];
+    if (command == "row") {
+      uint64_t code, scope, table, primary, payer;
+      std::string value;
+      if (args.size() != 7 || !name(1, &code) || !name(2, &scope) ||
+          !name(3, &table) || !number(4, &primary) || !name(5, &payer) ||
+          !bytes(6, &value)) {
+        return error("expected: row <code> <scope> <table> <primary> "
+                     "<payer> <value>");
+      }
+      state_.primary.Store(code, scope, table, payer, primary, value);
+    } else if (command == "kv") {
+      uint64_t contract;
+      std::string key, value;
+      if (args.size() != 4 || !name(1, &contract) || !bytes(2, &key) ||
+          !bytes(3, &value)) {
+        return error("expected: kv <contract> <key> <value>");
+      }
+      state_.kv.Set(contract, contract, key, value);
+    } else if (command == "auth") {
+      uint64_t account;
+      if (args.size() != 2 || !name(1, &account)) {
+        return error("expected: auth <account>");
+      }
+      auths_.insert(account);
+    } else if (command == "time") {
+      if (args.size() != 2 || !number(1, &time_)) {
+        return error("expected: time <microseconds>");
+      }
+    } else if (command == "return") {
+      uint64_t value;
+      if (args.size() != 3 || !number(2, &value)) {
+        return error("expected: return <import> <value>");
+      }
+      returns_[args[1]] = value;
+    } else if (command == "action") {
+      ActionRun run;
+      if (args.size() != 5 || !name(1, &run.receiver) || !name(2, &run.code) ||
+          !name(3, &run.action) || !bytes(4, &run.data)) {
+        return error("expected: action <receiver> <code> <action> <data>");
+      }
+      actions->push_back(run);
+    } else {
+      return error("unknown command");
+    }
+  }
+  return true;
+}
+
+void Host::SaveState(Stream& stream) {
+  for (auto& table : state_.primary.set().tables()) {
+    const TableId& id = table.first;
+    for (auto& row : table.second.rows) {
+      stream.Writef("row %s %s %s %" PRIu64 " %s %s\n",
+                    NameToString(id.code).c_str(),
+                    NameToString(id.scope).c_str(),
+                    NameToString(id.table).c_str(), row.first,
+                    NameToString(row.second.payer).c_str(),
+                    BytesToHex(row.second.value).c_str());
+    }
+  }
+  for (auto& db : state_.kv.dbs()) {
+    for (auto& pair : db.second) {
+      stream.Writef("kv %s %s %s\n", NameToString(db.first).c_str(),
+                    BytesToHex(pair.first).c_str(),
+                    BytesToHex(pair.second).c_str());
+    }
+  }
+}
+
+class HostDelegate : public HostImportDelegate {
+ public:
+  explicit HostDelegate(Host* host) : host_(host) {}
+
+  wabt::Result ImportFunc(interp::FuncImport*,
+                          interp::Func* func,
+                          interp::FuncSignature*,
+                          const ErrorCallback&) override {
+    host_->Bind(cast<HostFunc>(func));
+    return wabt::Result::Ok;
+  }
+
+  wabt::Result ImportTable(interp::TableImport*,
+                           interp::Table*,
+                           const ErrorCallback& callback) override {
+    callback("eosio-profile does not provide tables");
+    return wabt::Result::Error;
+  }
+
+  wabt::Result ImportMemory(interp::MemoryImport*,
+                            interp::Memory*,
+                            const ErrorCallback& callback) override {
+    callback("eosio-profile does not provide memories");
+    return wabt::Result::Error;
+  }
+
+  wabt::Result ImportGlobal(interp::GlobalImport*,
+                            interp::Global*,
+                            const ErrorCallback& callback) override {
+    callback("eosio-profile does not provide globals");
+    return wabt::Result::Error;
+  }
+
+ private:
+  Host* host_;
+};
+
+class BinaryReaderNames : public BinaryReaderNop {
+ public:
+  explicit BinaryReaderNames(std::vector<std::string>* names)
+      : names_(names) {}
+
+  wabt::Result OnImportFunc(Index import_index,
+                            string_view module_name,
+                            string_view field_name,
+                            Index func_index,
+                            Index sig_index) override {
+    SetName(func_index, field_name);
+    num_func_imports_++;
+    return wabt::Result::Ok;
+  }
+
+  // every function gets an entry, even those the name section leaves out
+  wabt::Result OnFunctionCount(Index count) override {
+    if (num_func_imports_ + count > names_->size()) {
+      names_->resize(num_func_imports_ + count);
+    }
+    return wabt::Result::Ok;
+  }
+
+  wabt::Result OnFunctionName(Index index, string_view name) override {
+    SetName(index, name);
+    return wabt::Result::Ok;
+  }
+
+ private:
+  void SetName(Index index, string_view name) {
+    if (index >= names_->size()) {
+      names_->resize(index + 1);
+    }
+    (*names_)[index] = name.to_string();
+  }
+
+  std::vector<std::string>* names_;
+  Index num_func_imports_ = 0;
+};
+
+// The call tree of one action, every node counting the instructions spent in
+// its own body on that path.
+class CallTree {
+ public:
+  struct Node {
+    Index func;
+    Index parent;
+    uint64_t self = 0;
+    std::map<Index, Index> children;
+  };
+
+  struct FuncCost {
+    uint64_t self = 0;
+    uint64_t total = 0;
+    uint64_t calls = 0;
+  };
+
+  CallTree() : nodes_(1) {
+    nodes_[0].func = kInvalidIndex;
+    nodes_[0].parent = kInvalidIndex;
+  }
+
+  void Enter(Index func) {
+    auto child = nodes_[current_].children.find(func);
+    if (child == nodes_[current_].children.end()) {
+      Node node;
+      node.func = func;
+      node.parent = current_;
+      nodes_.push_back(node);
+      child = nodes_[current_]
+                  .children.insert(std::make_pair(func, nodes_.size() - 1))
+                  .first;
+    }
+    current_ = child->second;
+    if (func >= calls_.size()) {
+      calls_.resize(func + 1);
+    }
+    ++calls_[func];
+  }
+
+  void Leave() {
+    if (current_ != 0) {
+      current_ = nodes_[current_].parent;
+    }
+  }
+
+  void Step() {
+    ++nodes_[current_].self;
+    ++total_;
+  }
+
+  uint64_t total() const { return total_; }
+
+  // Self, total and call counts by function.  A recursive function's total
+  // counts its outermost activation only.
+  std::map<Index, FuncCost> Costs() const {
+    std::map<Index, FuncCost> costs;
+    std::vector<uint64_t> inclusive(nodes_.size());
+    for (size_t i = nodes_.size(); i-- > 0;) {
+      inclusive[i] += nodes_[i].self;
+      if (i != 0) {
+        inclusive[nodes_[i].parent] += inclusive[i];
+      }
+    }
+    std::vector<Index> path;
+    Accumulate(0, inclusive, &path, &costs);
+    for (auto& cost : costs) {
+      cost.second.calls = calls_[cost.first];
+    }
+    return costs;
+  }
+
+  void WriteFolded(const std::string& root,
+                   const std::vector<std::string>& names,
+                   Stream& stream) const {
+    WriteFolded(0, root, names, stream);
+  }
+
+ private:
+  void Accumulate(Index node,
+                  const std::vector<uint64_t>& inclusive,
+                  std::vector<Index>* path,
+                  std::map<Index, FuncCost>* costs) const {
+    Index func = nodes_[node].func;
+    if (func != kInvalidIndex) {
+      FuncCost& cost = (*costs)[func];
+      cost.self += nodes_[node].self;
+      if (std::find(path->begin(), path->end(), func) == path->end()) {
+        cost.total += inclusive[node];
+      }
+      path->push_back(func);
+    }
+    for (auto& child : nodes_[node].children) {
+      Accumulate(child.second, inclusive, path, costs);
+    }
+    if (func != kInvalidIndex) {
+      path->pop_back();
+    }
+  }
+
+  void WriteFolded(Index node,
+                   const std::string& stack,
+                   const std::vector<std::string>& names,
+                   Stream& stream) const {
+    if (nodes_[node].self) {
+      stream.Writef("%s %" PRIu64 "\n", stack.c_str(), nodes_[node].self);
+    }
+    for (auto& child : nodes_[node].children) {
+      WriteFolded(child.second, stack + ";" + names[child.first], names,
+                  stream);
+    }
+  }
+
+  std::vector<Node> nodes_;
+  std::vector<uint64_t> calls_;
+  Index current_ = 0;
+  uint64_t total_ = 0;
+};
+
+enum class Status {
+  Ok,
+  Failed,
+  Limit,
+};
+
+// Runs the function at `entry` one instruction at a time.  Calls and returns
+// show up as changes in the depth of the call stack; a deeper stack means
+// the pc is at the entry of the callee.
+Status RunProfiled(Thread* thread,
+                   IstreamOffset entry,
+                   const std::map<IstreamOffset, Index>& funcs,
+                   CallTree* tree,
+                   interp::Result* out_result) {
+  const uint8_t* istream = thread->env()->istream().data.data();
+  const uint8_t alloca = Opcode(Opcode::InterpAlloca).GetCode();
+  const uint8_t drop_keep = Opcode(Opcode::InterpDropKeep).GetCode();
+  const uint8_t data = Opcode(Opcode::InterpData).GetCode();
+
+  thread->set_pc(entry);
+  tree->Enter(funcs.at(entry));
+  Index depth = thread->NumCalls();
+  for (;;) {
+    if (tree->total() >= s_max_instructions) {
+      return Status::Limit;
+    }
+    const uint8_t opcode = istream[thread->pc()];
+    if (opcode != alloca && opcode != drop_keep && opcode != data) {
+      tree->Step();
+    }
+    *out_result = thread->Run(1);
+    if (*out_result == interp::Result::Returned) {
+      tree->Leave();
+      return Status::Ok;
+    }
+    if (*out_result != interp::Result::Ok) {
+      return Status::Failed;
+    }
+    const Index new_depth = thread->NumCalls();
+    if (new_depth > depth) {
+      tree->Enter(funcs.at(thread->pc()));
+    } else if (new_depth < depth) {
+      tree->Leave();
+    }
+    depth = new_depth;
+  }
+}
+
+struct Runner {
+  const std::vector<uint8_t>& wasm;
+  std::vector<std::string> names;
+  Host host;
+  Stream* report;
+  FileStream* flame;
+
+  explicit Runner(const std::vector<uint8_t>& wasm) : wasm(wasm) {}
+
+  bool Run(const ActionRun& run);
+  void Report(const ActionRun& run,
+              Status status,
+              const std::string& error,
+              const CallTree& tree);
+};
+
+bool Runner::Run(const ActionRun& run) {
+  Environment env;
+  HostModule* host_module = env.AppendHostModule("env");
+  host_module->import_delegate.reset(new HostDelegate(&host));
+
+  ErrorHandlerFile error_handler(Location::Type::Binary);
+  ReadBinaryOptions options;
+  DefinedModule* module = nullptr;
+  if (Failed(ReadBinaryInterp(&env, wasm.data(), wasm.size(), &options,
+                              &error_handler, &module))) {
+    return false;
+  }
+
+  std::map<IstreamOffset, Index> funcs;
+  for (Index i = 0; i < env.GetFuncCount(); ++i) {
+    if (auto func = dyn_cast<DefinedFunc>(env.GetFunc(i))) {
+      funcs[func->offset] = i;
+    }
+  }
+  auto apply = std::find_if(
+      module->exports.begin(), module->exports.end(), [](const Export& e) {
+        return e.kind == ExternalKind::Func && e.name == "apply";
+      });
+  if (apply == module->exports.end()) {
+    fprintf(stderr, "eosio-profile: %s does not export apply\n", s_infile);
+    return false;
+  }
+
+  host.BeginAction(run, module->memory_index == kInvalidIndex
+                            ? nullptr
+                            : env.GetMemory(module->memory_index));
+  CallTree tree;
+  Thread thread(&env);
+  interp::Result result = interp::Result::Ok;
+  Status status = Status::Ok;
+  if (module->start_func_index != kInvalidIndex) {
+    status = RunProfiled(
+        &thread, cast<DefinedFunc>(env.GetFunc(module->start_func_index))->offset,
+        funcs, &tree, &result);
+  }
+  if (status == Status::Ok) {
+    thread.Reset();
+    for (uint64_t arg : {run.receiver, run.code, run.action}) {
+      Value value;
+      value.i64 = arg;
+      if (thread.Push(value) != interp::Result::Ok) {
+        return false;
+      }
+    }
+    status = RunProfiled(
+        &thread, cast<DefinedFunc>(env.GetFunc(apply->index))->offset, funcs,
+        &tree, &result);
+  }
+
+  std::string error;
+  if (status == Status::Failed) {
+    if (result == interp::Result::TrapHostTrapped && host.exited()) {
+      status = Status::Ok;
+    } else if (result == interp::Result::TrapHostTrapped) {
+      error = host.error();
+    } else {
+      error = ResultToString(result);
+    }
+  }
+  if (status != Status::Ok) {
+    host.RevertAction();
+  }
+  Report(run, status, error, tree);
+  return true;
+}
+
+void Runner::Report(const ActionRun& run,
+                    Status status,
+                    const std::string& error,
+                    const CallTree& tree) {
+  const std::string action =
+      NameToString(run.code) + "::" + NameToString(run.action);
+  report->Writef("%s on %s: ", action.c_str(),
+                 NameToString(run.receiver).c_str());
+  switch (status) {
+    case Status::Ok:
+      report->Writef("ok");
+      break;
+    case Status::Failed:
+      report->Writef("failed, %s", error.c_str());
+      break;
+    case Status::Limit:
+      report->Writef("stopped after %" PRIu64 " instructions",
+                     s_max_instructions);
+      break;
+  }
+  report->Writef("\n  instructions: %" PRIu64 "\n", tree.total());
+  if (host.inline_actions()) {
+    report->Writef("  inline actions: %u\n", host.inline_actions());
+  }
+  if (!host.notified().empty()) {
+    report->Writef("  notified:");
+    for (uint64_t account : host.notified()) {
+      report->Writef(" %s", NameToString(account).c_str());
+    }
+    report->Writef("\n");
+  }
+  if (s_print && !host.prints().empty()) {
+    report->Writef("  prints: %s\n", host.prints().c_str());
+  }
+
+  std::vector<std::pair<std::string, uint64_t>> host_calls(
+      host.host_calls().begin(), host.host_calls().end());
+  std::stable_sort(host_calls.begin(), host_calls.end(),
+                   [](const std::pair<std::string, uint64_t>& a,
+                      const std::pair<std::string, uint64_t>& b) {
+                     return a.second > b.second;
+                   });
+  if (!host_calls.empty()) {
+    report->Writef("  host calls:\n");
+    for (auto& call : host_calls) {
+      report->Writef("    %10" PRIu64 "  %s\n", call.second, call.first.c_str());
+    }
+  }
+
+  std::map<Index, CallTree::FuncCost> costs = tree.Costs();
+  std::vector<std::pair<Index, CallTree::FuncCost>> funcs(costs.begin(),
+                                                          costs.end());
+  std::stable_sort(funcs.begin(), funcs.end(),
+                   [](const std::pair<Index, CallTree::FuncCost>& a,
+                      const std::pair<Index, CallTree::FuncCost>& b) {
+                     return a.second.self > b.second.self;
+                   });
+  if (s_top && funcs.size() > s_top) {
+    funcs.resize(s_top);
+  }
+  report->Writef("  %10s %6s %10s %8s  %s\n", "self", "", "total", "calls",
+                 "function");
+  const double total = tree.total() ? tree.total() : 1;
+  for (auto& func : funcs) {
+    report->Writef("  %10" PRIu64 " %5.1f%% %10" PRIu64 " %8" PRIu64 "  %s\n",
+                   func.second.self, 100 * func.second.self / total,
+                   func.second.total, func.second.calls,
+                   names[func.first].c_str());
+  }
+  report->Writef("\n");
+
+  if (flame) {
+    tree.WriteFolded(action, names, *flame);
+  }
+}
+
+}  // end anonymous namespace
+
+int ProgramMain(int argc, char** argv) {
+  InitStdio();
+  ParseOptions(argc, argv);
+
+  std::vector<uint8_t> wasm;
+  if (Failed(ReadFile(s_infile, &wasm))) {
+    return 1;
+  }
+
+  Runner runner(wasm);
+  ReadBinaryOptions options;
+  options.read_debug_names = true;
+  BinaryReaderNames names_reader(&runner.names);
+  if (Failed(ReadBinary(wasm.data(), wasm.size(), &names_reader, &options))) {
+    return 1;
+  }
+  for (size_t i = 0; i < runner.names.size(); ++i) {
+    if (runner.names[i].empty()) {
+      runner.names[i] = "func[" + std::to_string(i) + "]";
+    }
+  }
+
+  std::vector<ActionRun> actions;
+  if (s_script && !runner.host.LoadScript(s_script, &actions)) {
+    return 1;
+  }
+  if (!s_action.empty()) {
+    ActionRun run;
+    if (s_data_file) {
+      std::vector<uint8_t> file_data;
+      if (Failed(ReadFile(s_data_file, &file_data))) {
+        return 1;
+      }
+      run.data.assign(file_data.begin(), file_data.end());
+    } else if (!HexToBytes(s_data, &run.data)) {
+      fprintf(stderr, "eosio-profile: --data is not hex\n");
+      return 1;
+    }
+    if (!StringToName(s_receiver, &run.receiver) ||
+        !StringToName(s_code.empty() ? s_receiver : s_code, &run.code) ||
+        !StringToName(s_action, &run.action) || !run.receiver) {
+      fprintf(stderr, "eosio-profile: invalid receiver, code or action\n");
+      return 1;
+    }
+    actions.push_back(run);
+  }
+  if (actions.empty()) {
+    fprintf(stderr,
+            "eosio-profile: nothing to run, pass --action or a script with "
+            "action lines\n");
+    return 1;
+  }
+
+  std::unique_ptr<FileStream> report_file;
+  if (s_outfile) {
+    report_file.reset(new FileStream(s_outfile));
+  }
+  std::unique_ptr<FileStream> flame_file;
+  if (s_flame) {
+    flame_file.reset(new FileStream(s_flame));
+  }
+  FileStream stdout_stream(stdout);
+  runner.report = report_file ? report_file.get() : &stdout_stream;
+  runner.flame = flame_file.get();
+
+  for (const ActionRun& run : actions) {
+    if (!runner.Run(run)) {
+      return 1;
+    }
+  }
+
+  if (!runner.host.unmodelled().empty()) {
+    runner.report->Writef("imports without a model, returning zero or the "
+                          "script's value:\n");
+    for (const std::string& name : runner.host.unmodelled()) {
+      runner.report->Writef("  %s\n", name.c_str());
+    }
+  }
+
+  if (s_save_state) {
+    FileStream state(s_save_state);
+    runner.host.SaveState(state);
+  }
+  return 0;
+}
+
+int main(int argc, char** argv) {
+  WABT_TRY
+  return ProgramMain(argc, argv);
+  WABT_CATCH_BAD_ALLOC_AND_EXIT
+}
@@ -0,0 +1,841 @@
+/*
+ * Copyright 2016 WebAssembly Community Group participants
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "src/binary-reader-nop.h"
+#include "src/binary-reader.h"
+#include "src/option-parser.h"
+#include "src/stream.h"
+
+using namespace wabt;
+
+static const char* s_outfile;
+static std::vector<std::string> s_infiles;
+static size_t s_top = 20;
+
+static const char s_description[] =
+R"(  Report where the bytes of a wasm module go: sections, data segments,
+  functions and the libraries the functions were compiled from (libc,
+  libc++, eosiolib or user code).  Libraries are taken from the DWARF
+  compile units when the module was built with -g, and guessed from the
+  function names otherwise.  Function names come from the name section,
+  then from the exports.  eosio-ld strips both unless the contract is
+  linked with --allow-names.
+
+  Given two modules, the report is the difference between them.
+
+examples:
+  # largest 20 functions and the per-library totals of hello.wasm
+  $ eosio-wasm-size hello.wasm
+
+  # what changed between two builds, every changed function listed
+  $ eosio-wasm-size -n 0 old/hello.wasm new/hello.wasm
+)";
+
+static void ParseOptions(int argc, char** argv) {
+  OptionParser parser("eosio-wasm-size", s_description);
+
+  parser.AddOption('h', "help", "Print this help message", [&parser]() {
+    parser.PrintHelp();
+    exit(0);
+  });
+  parser.AddOption('o', "output", "FILENAME",
+                   "Output file for the report, by default use stdout",
+                   [](const char* argument) { s_outfile = argument; });
+  parser.AddOption(
+      'n', "top", "N",
+      "Number of functions to list, largest first; 0 lists all (default 20)",
+      [](const std::string& argument) { s_top = atol(argument.c_str()); });
+  parser.AddArgument("filename", OptionParser::ArgumentCount::OneOrMore,
+                     [](const char* argument) {
+                       s_infiles.push_back(argument);
+                     });
+  parser.Parse(argc, argv);
+
+  if (s_infiles.size() > 2) {
+    fprintf(stderr, "eosio-wasm-size: expected one module, or two to diff\n");
+    exit(1);
+  }
+}
+
+namespace {
+
+enum class Library { User, Eosiolib, Libcxx, Libc, Count };
+
+const char* GetLibraryName(Library library) {
+  switch (library) {
+    case Library::Eosiolib:
+      return "eosiolib";
+    case Library::Libcxx:
+      return "libc++";
+    case Library::Libc:
+      return "libc";
+    default:
+      return "user";
+  }
+}
+
+// The CDT libraries are built from libraries/{eosiolib,libc++,libc,rt}, the
+// latter two with their musl and compiler-rt sources, so the compile unit
+// path says where a function came from.
+Library ClassifyPath(const std::string& path) {
+  auto contains = [&path](const char* part) {
+    return path.find(part) != std::string::npos;
+  };
+  if (contains("/eosiolib/")) {
+    return Library::Eosiolib;
+  }
+  if (contains("/libc++/") || contains("/libcxx/")) {
+    return Library::Libcxx;
+  }
+  if (contains("/libc/") || contains("/musl/") || contains("/rt/") ||
+      contains("compiler-rt")) {
+    return Library::Libc;
+  }
+  return Library::User;
+}
+
+// Function template specializations are demangled with their return type in
+// front, e.g. "void eosio::print<char const*>(char const*)".  Returns the
+// qualified name that follows it.
+std::string QualifiedName(const std::string& name) {
+  size_t start = 0;
+  int depth = 0;
+  for (size_t i = 0; i < name.size(); ++i) {
+    char c = name[i];
+    if (c == '<') {
+      ++depth;
+    } else if (c == '>') {
+      --depth;
+    } else if (depth == 0 && c == '(') {
+      break;
+    } else if (depth == 0 && c == ' ') {
+      start = i + 1;
+    }
+  }
+  return name.substr(start);
+}
+
+// Templates and inline functions are emitted into the compile unit that uses
+// them, so user units also hold library code; their names still tell.
+// wasm-ld demangles the names it writes unless --no-demangle is given, so
+// both the mangled and the demangled forms are matched.
+Library ClassifyName(const std::string& name) {
+  auto starts_with = [](const std::string& str, const char* prefix) {
+    return str.compare(0, strlen(prefix), prefix) == 0;
+  };
+  if (starts_with(name, "_Z")) {
+    if (starts_with(name, "_ZN5eosio") || starts_with(name, "_ZNK5eosio")) {
+      return Library::Eosiolib;
+    }
+    if (starts_with(name, "_ZNSt3__1") || starts_with(name, "_ZNKSt3__1") ||
+        starts_with(name, "_ZSt")) {
+      return Library::Libcxx;
+    }
+    return Library::User;
+  }
+  const std::string qualified = QualifiedName(name);
+  if (starts_with(qualified, "eosio::")) {
+    return Library::Eosiolib;
+  }
+  if (starts_with(qualified, "std::")) {
+    return Library::Libcxx;
+  }
+  if (starts_with(name, "__") && !starts_with(name, "__cxx")) {
+    return Library::Libc;
+  }
+  return Library::User;
+}
+
+// Just enough DWARF (versions 2 to 5) to map the code offset of every
+// subprogram to the path of its compile unit.  Anything that does not parse
+// ends the walk, the functions it would have covered fall back to their names.
+class DwarfReader {
+ public:
+  struct Sections {
+    string_view info;
+    string_view abbrev;
+    string_view str;
+    string_view line_str;
+  };
+
+  // Code section offset of each subprogram -> compile unit path.
+  static std::map<Offset, std::string> ReadUnits(const Sections& sections) {
+    std::map<Offset, std::string> units;
+    Cursor info(sections.info);
+    while (!info.AtEnd()) {
+      uint64_t length = info.U32();
+      if (!info.ok || length >= 0xfffffff0 || length > info.Remaining()) {
+        break;  // 64-bit DWARF is not produced for wasm32
+      }
+      Cursor unit(info.Slice(length));
+      uint16_t version = unit.U16();
+      uint8_t addr_size;
+      uint64_t abbrev_offset;
+      if (version >= 5) {
+        uint8_t unit_type = unit.U8();
+        addr_size = unit.U8();
+        abbrev_offset = unit.U32();
+        if (unit_type != kUnitCompile && unit_type != kUnitPartial) {
+          continue;
+        }
+      } else {
+        abbrev_offset = unit.U32();
+        addr_size = unit.U8();
+      }
+      if (!unit.ok || version < 2 || version > 5 ||
+          abbrev_offset >= sections.abbrev.size()) {
+        break;
+      }
+      if (!ReadUnit(sections, version, addr_size, abbrev_offset, &unit,
+                    &units)) {
+        break;
+      }
+    }
+    return units;
+  }
+
+ private:
+  static const uint8_t kUnitCompile = 0x01;
+  static const uint8_t kUnitPartial = 0x03;
+  static const uint64_t kTagCompileUnit = 0x11;
+  static const uint64_t kTagSubprogram = 0x2e;
+  static const uint64_t kAtName = 0x03;
+  static const uint64_t kAtLowPc = 0x11;
+  static const uint64_t kAtCompDir = 0x1b;
+
+  struct Cursor {
+    explicit Cursor(string_view data)
+        : pos(data.data()), end(data.data() + data.size()) {}
+
+    bool AtEnd() const { return pos >= end; }
+    size_t Remaining() const { return end - pos; }
+
+    uint64_t Fixed(size_t size) {
+      if (!ok || size > Remaining()) {
+        ok = false;
+        return 0;
+      }
+      uint64_t value = 0;
+      for (size_t i = 0; i < size; ++i) {
+        value |= uint64_t(uint8_t(pos[i])) << (8 * i);
+      }
+      pos += size;
+      return value;
+    }
+    uint8_t U8() { return Fixed(1); }
+    uint16_t U16() { return Fixed(2); }
+    uint32_t U32() { return Fixed(4); }
+
+    uint64_t Leb() {
+      uint64_t value = 0;
+      for (unsigned shift = 0; ok; shift += 7) {
+        uint8_t byte = U8();
+        if (shift < 64) {
+          value |= uint64_t(byte & 0x7f) << shift;
+        }
+        if (!(byte & 0x80)) {
+          break;
+        }
+      }
+      return value;
+    }
+
+    string_view Slice(uint64_t size) {
+      if (!ok || size > Remaining()) {
+        ok = false;
+        return {};
+      }
+      string_view slice(pos, size);
+      pos += size;
+      return slice;
+    }
+
+    string_view CStr() {
+      const char* nul = std::find(pos, end, '\0');
+      if (nul == end) {
+        ok = false;
+        return {};
+      }
+      string_view str(pos, nul - pos);
+      pos = nul + 1;
+      return str;
+    }
+
+    const char* pos;
+    const char* end;
+    bool ok = true;
+  };
+
+  struct AttrSpec {
+    uint64_t attr;
+    uint64_t form;
+    int64_t implicit_const;
+  };
+
+  struct Abbrev {
+    uint64_t tag;
+    std::vector<AttrSpec> attrs;
+  };
+
+  struct Value {
+    uint64_t number = 0;
+    string_view str;
+    bool is_str = false;
+    bool is_addr = false;
+  };
+
+  static std::map<uint64_t, Abbrev> ReadAbbrevs(string_view data) {
+    std::map<uint64_t, Abbrev> abbrevs;
+    Cursor cursor(data);
+    while (cursor.ok) {
+      uint64_t code = cursor.Leb();
+      if (code == 0) {
+        break;
+      }
+      Abbrev& abbrev = abbrevs[code];
+      abbrev.tag = cursor.Leb();
+      cursor.U8();  // DW_CHILDREN_*, the walk is flat
+      while (cursor.ok) {
+        AttrSpec spec{cursor.Leb(), cursor.Leb(), 0};
+        if (spec.attr == 0 && spec.form == 0) {
+          break;
+        }
+        if (spec.form == 0x21) {  // DW_FORM_implicit_const
+          spec.implicit_const = cursor.Leb();
+        }
+        abbrev.attrs.push_back(spec);
+      }
+    }
+    return abbrevs;
+  }
+
+  static string_view StrAt(string_view section, uint64_t offset) {
+    if (offset >= section.size()) {
+      return {};
+    }
+    Cursor cursor(section.substr(offset));
+    return cursor.CStr();
+  }
+
+  static bool ReadForm(const Sections& sections,
+                       uint16_t version,
+                       uint8_t addr_size,
+                       const AttrSpec& spec,
+                       uint64_t form,
+                       Cursor* cursor,
+                       Value* value) {
+    switch (form) {
+      case 0x01:  // addr
+        value->number = cursor->Fixed(addr_size);
+        value->is_addr = true;
+        break;
+      case 0x08:  // string
+        value->str = cursor->CStr();
+        value->is_str = true;
+        break;
+      case 0x0e:  // strp
+        value->str = StrAt(sections.str, cursor->U32());
+        value->is_str = true;
+        break;
+      case 0x1f:  // line_strp
+        value->str = StrAt(sections.line_str, cursor->U32());
+        value->is_str = true;
+        break;
+      case 0x0b:  // data1
+      case 0x0c:  // flag
+      case 0x11:  // ref1
+      case 0x25:  // strx1
+      case 0x29:  // addrx1
+        value->number = cursor->Fixed(1);
+        break;
+      case 0x05:  // data2
+      case 0x12:  // ref2
+      case 0x26:  // strx2
+      case 0x2a:  // addrx2
+        value->number = cursor->Fixed(2);
+        break;
+      case 0x27:  // strx3
+      case 0x2b:  // addrx3
+        value->number = cursor->Fixed(3);
+        break;
+      case 0x06:  // data4
+      case 0x13:  // ref4
+      case 0x17:  // sec_offset
+      case 0x1c:  // ref_sup4
+      case 0x1d:  // strp_sup
+      case 0x28:  // strx4
+      case 0x2c:  // addrx4
+        value->number = cursor->Fixed(4);
+        break;
+      case 0x10:  // ref_addr
+        value->number = cursor->Fixed(version == 2 ? addr_size : 4);
+        break;
+      case 0x07:  // data8
+      case 0x14:  // ref8
+      case 0x20:  // ref_sig8
+      case 0x24:  // ref_sup8
+        value->number = cursor->Fixed(8);
+        break;
+      case 0x1e:  // data16
+        cursor->Slice(16);
+        break;
+      case 0x0d:  // sdata
+      case 0x0f:  // udata
+      case 0x15:  // ref_udata
+      case 0x1a:  // strx
+      case 0x1b:  // addrx
+      case 0x22:  // loclistx
+      case 0x23:  // rnglistx
+        value->number = cursor->Leb();
+        break;
+      case 0x0a:  // block1
+        cursor->Slice(cursor->U8());
+        break;
+      case 0x03:  // block2
+        cursor->Slice(cursor->U16());
+        break;
+      case 0x04:  // block4
+        cursor->Slice(cursor->U32());
+        break;
+      case 0x09:  // block
+      case 0x18:  // exprloc
+        cursor->Slice(cursor->Leb());
+        break;
+      case 0x19:  // flag_present
+        value->number = 1;
+        break;
+      case 0x21:  // implicit_const
+        value->number = spec.implicit_const;
+        break;
+      case 0x16:  // indirect
+        return ReadForm(sections, version, addr_size, spec, cursor->Leb(),
+                        cursor, value);
+      default:
+        return false;
+    }
+    return cursor->ok;
+  }
+
+  static bool ReadUnit(const Sections& sections,
+                       uint16_t version,
+                       uint8_t addr_size,
+                       uint64_t abbrev_offset,
+                       Cursor* unit,
+                       std::map<Offset, std::string>* units) {
+    const auto abbrevs = ReadAbbrevs(sections.abbrev.substr(abbrev_offset));
+    std::string path;
+    while (!unit->AtEnd()) {
+      uint64_t code = unit->Leb();
+      if (code == 0) {
+        continue;  // end of a sibling list
+      }
+      auto abbrev = abbrevs.find(code);
+      if (!unit->ok || abbrev == abbrevs.end()) {
+        return false;
+      }
+
+      string_view name;
+      string_view comp_dir;
+      bool has_low_pc = false;
+      uint64_t low_pc = 0;
+      for (const AttrSpec& spec : abbrev->second.attrs) {
+        Value value;
+        if (!ReadForm(sections, version, addr_size, spec, spec.form, unit,
+                      &value)) {
+          return false;
+        }
+        if (spec.attr == kAtName && value.is_str) {
+          name = value.str;
+        } else if (spec.attr == kAtCompDir && value.is_str) {
+          comp_dir = value.str;
+        } else if (spec.attr == kAtLowPc && value.is_addr) {
+          has_low_pc = true;
+          low_pc = value.number;
+        }
+      }
+
+      if (abbrev->second.tag == kTagCompileUnit) {
+        path = name.to_string();
+        if (!path.empty() && path[0] != '/' && !comp_dir.empty()) {
+          path = comp_dir.to_string() + "/" + path;
+        }
+      } else if (abbrev->second.tag == kTagSubprogram && has_low_pc &&
+                 low_pc != 0) {
+        // wasm-ld leaves 0 (or -1/-2 in newer versions) in the debug info of
+        // functions it discarded; those do not match any function below.
+        units->emplace(low_pc, path);
+      }
+    }
+    return true;
+  }
+};
+
+struct FunctionSize {
+  std::string name;
+  Offset size = 0;
+  Library library = Library::User;
+};
+
+struct DataSegmentSize {
+  bool has_offset = false;
+  uint32_t offset = 0;
+  Offset size = 0;
+};
+
+struct SizeReport {
+  Offset total = 0;
+  std::vector<std::pair<std::string, Offset>> sections;
+  std::vector<FunctionSize> functions;
+  std::vector<DataSegmentSize> data_segments;
+
+  Offset library_size(Library library) const {
+    Offset size = 0;
+    for (const FunctionSize& func : functions) {
+      if (func.library == library) {
+        size += func.size;
+      }
+    }
+    return size;
+  }
+
+  Offset data_size() const {
+    Offset size = 0;
+    for (const DataSegmentSize& segment : data_segments) {
+      size += segment.size;
+    }
+    return size;
+  }
+};
+
+class BinaryReaderSize : public BinaryReaderNop {
+ public:
+  explicit BinaryReaderSize(SizeReport* report) : report_(report) {}
+
+  Result BeginSection(BinarySection section_type, Offset size) override {
+    section_end_ = state->offset + size;
+    if (section_type == BinarySection::Code) {
+      code_start_ = state->offset;
+    }
+    if (section_type != BinarySection::Custom) {
+      report_->sections.emplace_back(GetSectionName(section_type), size);
+    }
+    return Result::Ok;
+  }
+
+  Result BeginCustomSection(Offset size, string_view section_name) override {
+    report_->sections.emplace_back("\"" + section_name.to_string() + "\"",
+                                   size);
+    string_view contents(
+        reinterpret_cast<const char*>(state->data) + state->offset,
+        section_end_ - state->offset);
+    if (section_name == ".debug_info") {
+      dwarf_.info = contents;
+    } else if (section_name == ".debug_abbrev") {
+      dwarf_.abbrev = contents;
+    } else if (section_name == ".debug_str") {
+      dwarf_.str = contents;
+    } else if (section_name == ".debug_line_str") {
+      dwarf_.line_str = contents;
+    }
+    return Result::Ok;
+  }
+
+  Result OnExport(Index index,
+                  ExternalKind kind,
+                  Index item_index,
+                  string_view name) override {
+    if (kind == ExternalKind::Func) {
+      export_names_.emplace(item_index, name.to_string());
+    }
+    return Result::Ok;
+  }
+
+  Result BeginFunctionBody(Index index) override {
+    body_start_ = state->offset;
+    return Result::Ok;
+  }
+
+  Result EndFunctionBody(Index index) override {
+    bodies_.push_back({index, body_start_ - code_start_,
+                       state->offset - body_start_});
+    return Result::Ok;
+  }
+
+  Result BeginDataSegment(Index index, Index memory_index) override {
+    report_->data_segments.emplace_back();
+    return Result::Ok;
+  }
+
+  Result OnInitExprI32ConstExpr(Index index, uint32_t value) override {
+    if (index < report_->data_segments.size()) {
+      report_->data_segments[index].has_offset = true;
+      report_->data_segments[index].offset = value;
+    }
+    return Result::Ok;
+  }
+
+  Result OnDataSegmentData(Index index,
+                           const void* data,
+                           Address size) override {
+    report_->data_segments[index].size = size;
+    return Result::Ok;
+  }
+
+  Result OnFunctionName(Index index, string_view name) override {
+    names_[index] = name.to_string();
+    return Result::Ok;
+  }
+
+  Result EndModule() override {
+    report_->total = state->size;
+    const auto units = DwarfReader::ReadUnits(dwarf_);
+    for (const Body& body : bodies_) {
+      FunctionSize func;
+      func.size = body.size;
+      func.name = GetName(body.index);
+
+      // Producers disagree on whether a subprogram starts at the body size
+      // or right after it, either way it is inside the body.
+      auto unit = units.lower_bound(body.offset);
+      if (unit != units.end() && unit->first < body.offset + body.size) {
+        func.library = ClassifyPath(unit->second);
+      }
+      if (func.library == Library::User) {
+        func.library = ClassifyName(func.name);
+      }
+      report_->functions.push_back(std::move(func));
+    }
+    return Result::Ok;
+  }
+
+ private:
+  struct Body {
+    Index index;
+    Offset offset;
+    Offset size;
+  };
+
+  std::string GetName(Index index) const {
+    auto name = names_.find(index);
+    if (name != names_.end()) {
+      return name->second;
+    }
+    auto export_name = export_names_.find(index);
+    if (export_name != export_names_.end()) {
+      return export_name->second;
+    }
+    return "func[" + std::to_string(index) + "]";
+  }
+
+  SizeReport* report_;
+  Offset section_end_ = 0;
+  Offset code_start_ = 0;
+  Offset body_start_ = 0;
+  std::vector<Body> bodies_;
+  std::map<Index, std::string> names_;
+  std::map<Index, std::string> export_names_;
+  DwarfReader::Sections dwarf_;
+};
+
+Result ReadSizeReport(const std::string& filename, SizeReport* report) {
+  std::vector<uint8_t> file_data;
+  if (Failed(ReadFile(filename, &file_data))) {
+    return Result::Error;
+  }
+  const bool kReadDebugNames = true;
+  const bool kStopOnFirstError = true;
+  const bool kFailOnCustomSectionError = false;
+  ReadBinaryOptions options(Features(), nullptr, kReadDebugNames,
+                            kStopOnFirstError, kFailOnCustomSectionError);
+  BinaryReaderSize reader(report);
+  return ReadBinary(file_data.data(), file_data.size(), &reader, &options);
+}
+
+double Percent(Offset part, Offset whole) {
+  return whole ? 100.0 * part / whole : 0.0;
+}
+
+template <typename T>
+void SortAndTrim(std::vector<T>* items, size_t top) {
+  std::stable_sort(items->begin(), items->end(),
+                   [](const T& lhs, const T& rhs) {
+                     return std::llabs(lhs.second) > std::llabs(rhs.second);
+                   });
+  if (top && items->size() > top) {
+    items->resize(top);
+  }
+}
+
+void WriteReport(Stream& stream, const SizeReport& report) {
+  stream.Writef("sections:\n");
+  for (const auto& section : report.sections) {
+    stream.Writef("  %-24s %10" PRIzd " %6.2f%%\n", section.first.c_str(),
+                  section.second, Percent(section.second, report.total));
+  }
+  stream.Writef("  %-24s %10" PRIzd "\n", "total", report.total);
+
+  Offset code = 0;
+  for (const FunctionSize& func : report.functions) {
+    code += func.size;
+  }
+  stream.Writef("\nlibraries:\n");
+  for (int i = 0; i < static_cast<int>(Library::Count); ++i) {
+    Library library = static_cast<Library>(i);
+    Offset size = report.library_size(library);
+    stream.Writef("  %-24s %10" PRIzd " %6.2f%%\n", GetLibraryName(library),
+                  size, Percent(size, code));
+  }
+  stream.Writef("  %-24s %10" PRIzd " %6.2f%%\n", "data segments",
+                report.data_size(), Percent(report.data_size(), report.total));
+
+  stream.Writef("\ndata segments:\n");
+  for (size_t i = 0; i < report.data_segments.size(); ++i) {
+    const DataSegmentSize& segment = report.data_segments[i];
+    if (segment.has_offset) {
+      stream.Writef("  segment[%" PRIzd "] %10u %10" PRIzd "\n", i,
+                    segment.offset, segment.size);
+    } else {
+      stream.Writef("  segment[%" PRIzd "] %10s %10" PRIzd "\n", i, "-",
+                    segment.size);
+    }
+  }
+
+  std::vector<std::pair<const FunctionSize*, int64_t>> sorted;
+  for (const FunctionSize& func : report.functions) {
+    sorted.emplace_back(&func, func.size);
+  }
+  SortAndTrim(&sorted, s_top);
+  stream.Writef("\nfunctions (%" PRIzd " of %" PRIzd "):\n", sorted.size(),
+                report.functions.size());
+  for (const auto& func : sorted) {
+    stream.Writef("  %10" PRIzd " %6.2f%%  %-9s %s\n", func.first->size,
+                  Percent(func.first->size, code),
+                  GetLibraryName(func.first->library),
+                  func.first->name.c_str());
+  }
+}
+
+void WriteDiffLine(Stream& stream, const std::string& name,
+                   int64_t before, int64_t after) {
+  stream.Writef("  %-24s %10" PRId64 " %10" PRId64 " %+10" PRId64 "\n",
+                name.c_str(), before, after, after - before);
+}
+
+void WriteDiff(Stream& stream, const SizeReport& before,
+               const SizeReport& after) {
+  // Sections and functions are matched by name, whatever only exists on one
+  // side counts as zero on the other.
+  auto diff = [](const std::vector<std::pair<std::string, int64_t>>& lhs,
+                 const std::vector<std::pair<std::string, int64_t>>& rhs) {
+    std::map<std::string, std::pair<int64_t, int64_t>> sizes;
+    for (const auto& item : lhs) {
+      sizes[item.first].first += item.second;
+    }
+    for (const auto& item : rhs) {
+      sizes[item.first].second += item.second;
+    }
+    return sizes;
+  };
+  auto section_sizes = [](const SizeReport& report) {
+    std::vector<std::pair<std::string, int64_t>> sizes;
+    for (const auto& section : report.sections) {
+      sizes.emplace_back(section.first, section.second);
+    }
+    return sizes;
+  };
+  auto function_sizes = [](const SizeReport& report) {
+    std::vector<std::pair<std::string, int64_t>> sizes;
+    for (const FunctionSize& func : report.functions) {
+      sizes.emplace_back(func.name, func.size);
+    }
+    return sizes;
+  };
+
+  stream.Writef("%-26s %10s %10s %10s\n", "sections:", "before", "after",
+                "delta");
+  for (const auto& section :
+       diff(section_sizes(before), section_sizes(after))) {
+    WriteDiffLine(stream, section.first, section.second.first,
+                  section.second.second);
+  }
+  WriteDiffLine(stream, "total", before.total, after.total);
+
+  stream.Writef("\nlibraries:\n");
+  for (int i = 0; i < static_cast<int>(Library::Count); ++i) {
+    Library library = static_cast<Library>(i);
+    WriteDiffLine(stream, GetLibraryName(library),
+                  before.library_size(library), after.library_size(library));
+  }
+  WriteDiffLine(stream, "data segments", before.data_size(),
+                after.data_size());
+
+  std::vector<std::pair<std::string, int64_t>> changed;
+  std::map<std::string, std::pair<int64_t, int64_t>> functions =
+      diff(function_sizes(before), function_sizes(after));
+  for (const auto& func : functions) {
+    int64_t delta = func.second.second - func.second.first;
+    if (delta) {
+      changed.emplace_back(func.first, delta);
+    }
+  }
+  const size_t num_changed = changed.size();
+  SortAndTrim(&changed, s_top);
+  stream.Writef("\nfunctions (%" PRIzd " of %" PRIzd " changed):\n",
+                changed.size(), num_changed);
+  for (const auto& func : changed) {
+    const auto& sizes = functions[func.first];
+    WriteDiffLine(stream, func.first, sizes.first, sizes.second);
+  }
+}
+
+}  // end anonymous namespace
+
+int ProgramMain(int argc, char** argv) {
+  InitStdio();
+  ParseOptions(argc, argv);
+
+  std::vector<SizeReport> reports(s_infiles.size());
+  for (size_t i = 0; i < s_infiles.size(); ++i) {
+    if (Failed(ReadSizeReport(s_infiles[i], &reports[i]))) {
+      fprintf(stderr, "eosio-wasm-size: unable to read %s\n",
+              s_infiles[i].c_str());
+      return 1;
+    }
+  }
+
+  FileStream stream(s_outfile ? FileStream(s_outfile) : FileStream(stdout));
+  if (reports.size() == 1) {
+    WriteReport(stream, reports[0]);
+  } else {
+    WriteDiff(stream, reports[0], reports[1]);
+  }
+  return 0;
+}
+
+int main(int argc, char** argv) {
+  WABT_TRY
+  return ProgramMain(argc, argv);
+  WABT_CATCH_BAD_ALLOC_AND_EXIT
+}
@@ -21,9 +21,11 @@
 #include <eosio/utils.hpp>
 #include <eosio/whereami/whereami.hpp>
 #include <eosio/abi.hpp>
+#include <eosio/abigen.hpp>
 #include <eosio/ppcallbacks.hpp>
 
 #include <exception>
+#include <functional>
 #include <iostream>
 #include <fstream>
 #include <sstream>
@@ -172,6 +174,8 @@ namespace eosio { namespace cdt {
                ss << ":";
                ss << func_name << nm;
                ss << "\"))) void " << func_name << nm << "(unsigned long long r, unsigned long long c) {\n";
+               // the action data buffer stays alive until the action returns; parameters declared as
+               // std::string_view or eosio::bytes_view are deserialized as views into it rather than copies
                ss << "size_t as = ::action_data_size();\n";
                ss << "void* buff = nullptr;\n";
                ss << "if (as > 0) {\n";
@@ -529,4 +533,55 @@ namespace eosio { namespace cdt {
          }
    };
 
+   /*
+    * Runs the abigen and codegen visitors over a single parse of the translation unit.  `abigen_done` is called
+    * between the two, once abigen finished without errors, to hand the ABI to codegen; codegen is skipped when it
+    * returns false.
+    */
+   class eosio_abigen_codegen_consumer : public ASTConsumer {
+      private:
+         eosio_abigen_consumer abigen_consumer;
+         std::string           main_file;
+         CompilerInstance*     ci;
+         std::function<bool()> abigen_done;
+
+      public:
+         explicit eosio_abigen_codegen_consumer(CompilerInstance *CI, std::string file, std::function<bool()> done)
+            : abigen_consumer(CI, file), main_file(file), ci(CI), abigen_done(std::move(done)) { }
+
+         virtual void HandleTranslationUnit(ASTContext &Context) {
+            abigen_consumer.HandleTranslationUnit(Context);
+            if (Context.getDiagnostics().hasErrorOccurred() || !abigen_done())
+               return;
+            eosio_codegen_consumer(ci, main_file).HandleTranslationUnit(Context);
+         }
+   };
+
+   class eosio_abigen_codegen_frontend_action : public ASTFrontendAction {
+      private:
+         std::function<bool()> abigen_done;
+
+      public:
+         explicit eosio_abigen_codegen_frontend_action(std::function<bool()> done)
+            : abigen_done(std::move(done)) { }
+
+         virtual std::unique_ptr<ASTConsumer> CreateASTConsumer(CompilerInstance &CI, StringRef file) {
+            CI.getPreprocessor().addPPCallbacks(std::make_unique<eosio_ppcallbacks>(CI.getSourceManager(), file.str()));
+            return std::make_unique<eosio_abigen_codegen_consumer>(&CI, file, abigen_done);
+         }
+   };
+
+   class eosio_abigen_codegen_action_factory : public FrontendActionFactory {
+      private:
+         std::function<bool()> abigen_done;
+
+      public:
+         explicit eosio_abigen_codegen_action_factory(std::function<bool()> done)
+            : abigen_done(std::move(done)) { }
+
+         FrontendAction* create() override {
+            return new eosio_abigen_codegen_frontend_action(abigen_done);
+         }
+   };
+
 }} // ns eosio::cdt
@@ -0,0 +1,84 @@
+#pragma once
+#include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/Process.h"
+#include "llvm/Support/SHA1.h"
+
+#include <string>
+#include <vector>
+
+namespace eosio { namespace cdt {
+
+/**
+ * On-disk cache of eosio-cpp objects, addressed by the SHA-1 of everything that goes into one: the preprocessed
+ * source, the compiler flags, the ABI settings and the ricardian files codegen embeds.  The object already carries
+ * the generated ABI and dispatcher, so a hit skips abigen, codegen and the compile alike.
+ */
+class compile_cache {
+   public:
+      explicit compile_cache(std::string dir) : dir(std::move(dir)) {}
+
+      void add(llvm::StringRef data) {
+         // length prefixed, so that neighbouring fields cannot run into each other
+         hasher.update(std::to_string(data.size()) + ":");
+         hasher.update(data);
+      }
+
+      void add(const std::vector<std::string>& data) {
+         add(std::to_string(data.size()));
+         for (const auto& d : data)
+            add(d);
+      }
+
+      /// Adds the contents of a file, or a marker for its absence
+      void add_file(const std::string& fn) {
+         auto mb = llvm::MemoryBuffer::getFile(fn);
+         if (mb) {
+            add("file");
+            add(mb.get()->getBuffer());
+         } else {
+            add("nofile");
+         }
+      }
+
+      /// Finishes the key, no more data can be added afterwards
+      const std::string& key() {
+         if (hash.empty())
+            hash = llvm::toHex(hasher.final(), true);
+         return hash;
+      }
+
+      /// Copies the cached object to `output`, returns false on a miss
+      bool fetch(const std::string& output) {
+         const std::string cached = entry();
+         if (!llvm::sys::fs::exists(cached))
+            return false;
+         return !llvm::sys::fs::copy_file(cached, output);
+      }
+
+      /// Stores `output` under the key; concurrent compilers may race for the same entry, so it is written to a
+      /// unique file first and renamed into place
+      void store(const std::string& output) {
+         if (llvm::sys::fs::create_directories(dir))
+            return;
+         int fd;
+         llvm::SmallString<128> tmp;
+         if (llvm::sys::fs::createUniqueFile(dir+"/"+key()+"-%%%%%%.tmp", fd, tmp))
+            return;
+         llvm::sys::Process::SafelyCloseFileDescriptor(fd);
+         if (llvm::sys::fs::copy_file(output, tmp) || llvm::sys::fs::rename(tmp, entry()))
+            llvm::sys::fs::remove(tmp);
+      }
+
+   private:
+      std::string entry() { return dir+"/"+key()+".o"; }
+
+      std::string dir;
+      llvm::SHA1  hasher;
+      std::string hash;
+};
+
+}} // ns eosio::cdt
@@ -0,0 +1,137 @@
+#pragma once
+#include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/Process.h"
+#include "llvm/Support/SHA1.h"
+
+#include <eosio/in_process.hpp>
+
+#include <set>
+#include <string>
+#include <vector>
+
+namespace eosio { namespace cdt {
+
+/**
+ * Precompiled <eosio/eosio.hpp> shared by the abigen/codegen parse and the compile of every input that starts by
+ * including it, so the bulk of eosiolib, boost and libc++ is parsed once per flag set rather than for every file.
+ *
+ * The header is precompiled on first use into the user's cache directory, under a name derived from the tool
+ * version and every flag that has to match between a PCH and its users; stale headers are caught by clang's own
+ * verification and rebuilt.
+ */
+struct eosiolib_pch {
+   /// Path of the PCH matching `options`, built if necessary; empty if there is none
+   static std::string get(const std::vector<std::string>& options, const std::string& version, bool in_proc) {
+      const auto flags  = pch_flags(options);
+      const auto header = find_header(flags);
+      if (header.empty())
+         return {};
+
+      llvm::SmallString<128> dir;
+      if (!llvm::sys::path::cache_directory(dir))
+         return {};
+      llvm::sys::path::append(dir, "eosio.cdt", "pch");
+
+      llvm::SHA1 hasher;
+      hasher.update(version);
+      hasher.update(header);
+      for (const auto& flag : flags) {
+         hasher.update(flag);
+         hasher.update(llvm::StringRef("\0", 1));
+      }
+      const std::string pch = std::string(dir.str())+"/eosio-"+llvm::toHex(hasher.final(), true)+".pch";
+
+      if (llvm::sys::fs::exists(pch)) {
+         auto verify = flags;
+         verify.insert(verify.end(), {"-verify-pch", pch});
+         if (run_clang(in_proc, verify))
+            return pch;
+      }
+      return build(flags, header, dir.str().str(), pch, in_proc) ? pch : std::string();
+   }
+
+   /// Whether the first thing `input` does is including <eosio/eosio.hpp>, which makes the PCH a drop-in for it
+   static bool applies_to(const std::string& input) {
+      auto mb = llvm::MemoryBuffer::getFile(input);
+      if (!mb)
+         return false;
+      llvm::StringRef src = mb.get()->getBuffer();
+      while (true) {
+         src = src.ltrim();
+         if (src.startswith("//")) {
+            src = src.drop_until([](char c) { return c == '\n'; });
+         } else if (src.startswith("/*")) {
+            const auto end = src.find("*/");
+            if (end == llvm::StringRef::npos)
+               return false;
+            src = src.drop_front(end + 2);
+         } else {
+            break;
+         }
+      }
+      if (!src.consume_front("#"))
+         return false;
+      src = src.ltrim(" \t");
+      if (!src.consume_front("include"))
+         return false;
+      return src.ltrim(" \t").startswith("<eosio/eosio.hpp>");
+   }
+
+   private:
+      // the compile options minus those that only concern outputs and diagnostics
+      static std::vector<std::string> pch_flags(const std::vector<std::string>& options) {
+         static const std::set<std::string> output_only = { "-c", "-S", "-emit-llvm", "-emit-ast", "-v", "-w",
+                                                            "-fcolor-diagnostics", "-MD", "-MMD" };
+         std::vector<std::string> flags;
+         for (size_t i=0; i < options.size(); i++) {
+            llvm::StringRef opt = options[i];
+            if (opt == "-MF") {
+               i++;
+               continue;
+            }
+            if (output_only.count(opt.str()) || opt.startswith("-MT") || opt.startswith("-W") || opt.startswith("-x"))
+               continue;
+            flags.push_back(opt.str());
+         }
+         return flags;
+      }
+
+      // <eosio/eosio.hpp> as the include path of `flags` resolves it
+      static std::string find_header(const std::vector<std::string>& flags) {
+         for (llvm::StringRef flag : flags) {
+            if (!flag.consume_front("-I") && !flag.consume_front("-isystem="))
+               continue;
+            const std::string header = flag.str()+"/eosio/eosio.hpp";
+            if (llvm::sys::fs::exists(header))
+               return header;
+         }
+         return {};
+      }
+
+      // written under a unique name and renamed into place, compilers running in parallel may build it as well
+      static bool build(const std::vector<std::string>& flags, const std::string& header, const std::string& dir,
+                        const std::string& pch, bool in_proc) {
+         if (llvm::sys::fs::create_directories(dir))
+            return false;
+         int fd;
+         llvm::SmallString<128> tmp;
+         if (llvm::sys::fs::createUniqueFile(pch+"-%%%%%%.tmp", fd, tmp))
+            return false;
+         llvm::sys::Process::SafelyCloseFileDescriptor(fd);
+
+         auto options = flags;
+         options.insert(options.end(), {"-Wno-pragma-once-outside-header", "-xc++-header", header, "-o", tmp.str().str()});
+         if (!run_clang(in_proc, options) || llvm::sys::fs::rename(tmp, pch)) {
+            llvm::sys::fs::remove(tmp);
+            return false;
+         }
+         return true;
+      }
+};
+
+}} // ns eosio::cdt
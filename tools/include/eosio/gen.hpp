@@ -457,6 +457,9 @@ struct generation_utils {
          {"signed_int",   "varint32"},
 
          {"basic_string<char>", "string"},
+         {"string_view", "string"},
+         {"basic_string_view<char>", "string"},
+         {"bytes_view", "bytes"},
 
          {"block_timestamp", "block_timestamp_type"},
          {"capi_name",    "name"},
@@ -0,0 +1,163 @@
+#pragma once
+#include "clang/Basic/Diagnostic.h"
+#include "clang/Basic/DiagnosticOptions.h"
+#include "clang/CodeGen/CodeGenAction.h"
+#include "clang/Driver/Compilation.h"
+#include "clang/Driver/Driver.h"
+#include "clang/Driver/Job.h"
+#include "clang/Driver/Tool.h"
+#include "clang/Frontend/CompilerInstance.h"
+#include "clang/Frontend/CompilerInvocation.h"
+#include "clang/Frontend/FrontendActions.h"
+#include "clang/Frontend/TextDiagnosticPrinter.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/DynamicLibrary.h"
+#include "llvm/Support/Host.h"
+#include "llvm/Support/Program.h"
+#include "llvm/Support/TargetSelect.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <eosio/utils.hpp>
+#include <eosio/whereami/whereami.hpp>
+
+#include <memory>
+#include <set>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace eosio { namespace cdt {
+
+/**
+ * Runs the clang-9 command lines of the tools inside the calling process.  The driver is only used to translate
+ * the command line into its -cc1 jobs, which are then executed with a CompilerInstance of their own, so the
+ * process start, program lookup and LLVM initialization are paid once per tool run instead of once per input.
+ * Command lines the frontend actions below do not cover are handed to a clang-9 subprocess as before.
+ */
+struct in_process {
+   static bool compile(const std::vector<std::string>& options) {
+      const auto clang_path = llvm::sys::findProgramByName("clang-9", {eosio::cdt::whereami::where()});
+      if (!clang_path)
+         return false;
+      init_llvm();
+
+      // the driver derives the resource directory from the path of the executable it is told it runs as
+      std::vector<const char*> argv = {clang_path->c_str()};
+      for (const auto& opt : options)
+         argv.push_back(opt.c_str());
+
+      llvm::IntrusiveRefCntPtr<clang::DiagnosticOptions> diag_opts = new clang::DiagnosticOptions;
+      clang::DiagnosticsEngine diags(new clang::DiagnosticIDs, &*diag_opts,
+                                     new clang::TextDiagnosticPrinter(llvm::errs(), &*diag_opts));
+      clang::driver::Driver driver(*clang_path, llvm::sys::getDefaultTargetTriple(), diags);
+      std::unique_ptr<clang::driver::Compilation> compilation(driver.BuildCompilation(argv));
+      if (!compilation || compilation->containsError())
+         return false;
+
+      std::vector<std::pair<std::unique_ptr<clang::CompilerInstance>, std::unique_ptr<clang::FrontendAction>>> jobs;
+      for (const auto& job : compilation->getJobs()) {
+         const auto& args = job.getArguments();
+         if (llvm::StringRef(job.getCreator().getName()) != "clang" || args.empty() || llvm::StringRef(args[0]) != "-cc1")
+            return environment::exec_subprogram("clang-9", options);
+
+         auto ci = std::make_unique<clang::CompilerInstance>();
+         if (!clang::CompilerInvocation::CreateFromArgs(ci->getInvocation(), args.data()+1, args.data()+args.size(), diags))
+            return false;
+         auto action = create_action(ci->getFrontendOpts().ProgramAction);
+         if (!action)
+            return environment::exec_subprogram("clang-9", options);
+         jobs.emplace_back(std::move(ci), std::move(action));
+      }
+
+      for (auto& job : jobs) {
+         auto& ci = *job.first;
+         ci.createDiagnostics();
+         if (!ci.hasDiagnostics() || !load_plugins(ci.getFrontendOpts().Plugins) ||
+             !apply_llvm_args(ci.getFrontendOpts().LLVMArgs))
+            return false;
+         if (!ci.ExecuteAction(*job.second))
+            return false;
+      }
+      return true;
+   }
+
+   private:
+      static void init_llvm() {
+         static bool initialized = false;
+         if (initialized)
+            return;
+         llvm::InitializeAllTargets();
+         llvm::InitializeAllTargetMCs();
+         llvm::InitializeAllAsmPrinters();
+         llvm::InitializeAllAsmParsers();
+         initialized = true;
+      }
+
+      static std::unique_ptr<clang::FrontendAction> create_action(clang::frontend::ActionKind kind) {
+         switch (kind) {
+            case clang::frontend::EmitObj:
+               return std::make_unique<clang::EmitObjAction>();
+            case clang::frontend::EmitBC:
+               return std::make_unique<clang::EmitBCAction>();
+            case clang::frontend::EmitLLVM:
+               return std::make_unique<clang::EmitLLVMAction>();
+            case clang::frontend::EmitAssembly:
+               return std::make_unique<clang::EmitAssemblyAction>();
+            case clang::frontend::PrintPreprocessedInput:
+               return std::make_unique<clang::PrintPreprocessedAction>();
+            case clang::frontend::GeneratePCH:
+               return std::make_unique<clang::GeneratePCHAction>();
+            case clang::frontend::VerifyPCH:
+               return std::make_unique<clang::VerifyPCHAction>();
+            default:
+               return nullptr;
+         }
+      }
+
+      // the eosio passes and plugins register themselves when loaded, which only has to happen once per process
+      static bool load_plugins(const std::vector<std::string>& plugins) {
+         static std::set<std::string> loaded;
+         for (const auto& plugin : plugins) {
+            if (loaded.count(plugin))
+               continue;
+            std::string err;
+            if (llvm::sys::DynamicLibrary::LoadLibraryPermanently(plugin.c_str(), &err)) {
+               llvm::errs() << "unable to load plugin '" << plugin << "': " << err << '\n';
+               return false;
+            }
+            loaded.insert(plugin);
+         }
+         return true;
+      }
+
+      // -mllvm options go straight to the registered options, a second ParseCommandLineOptions would trip over the
+      // required positional inputs of the tool itself.  Options only occur once in a process, like in a cc1 run.
+      static bool apply_llvm_args(const std::vector<std::string>& args) {
+         static std::set<std::string> applied;
+         auto& registered = llvm::cl::getRegisteredOptions();
+         for (const auto& arg : args) {
+            if (applied.count(arg))
+               continue;
+            llvm::StringRef name = llvm::StringRef(arg).ltrim('-');
+            llvm::StringRef value;
+            std::tie(name, value) = name.split('=');
+            auto opt = registered.find(name);
+            if (opt == registered.end()) {
+               llvm::errs() << "unknown llvm argument '" << arg << "'\n";
+               return false;
+            }
+            if (opt->second->addOccurrence(0, name, value))
+               return false;
+            applied.insert(arg);
+         }
+         return true;
+      }
+};
+
+/// Runs clang-9 with `options`, inside this process if `in_proc` is set
+inline bool run_clang(bool in_proc, const std::vector<std::string>& options) {
+   return in_proc ? in_process::compile(options) : environment::exec_subprogram("clang-9", options);
+}
+
+}} // ns eosio::cdt
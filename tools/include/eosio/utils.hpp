@@ -13,6 +13,9 @@ extern char **environ;
 #endif
 
 #include "whereami/whereami.hpp"
+#include <algorithm>
+#include <atomic>
+#include <thread>
 #include <vector>
 #include <sstream>
 
@@ -148,4 +151,28 @@ struct environment {
    }
 
 };
+
+/**
+ * Runs `job(i)` for every `i` below `count` on up to `jobs` threads, the calling thread included.  Once a job
+ * fails no further ones are started; returns whether all of the jobs that ran succeeded.
+ */
+template <typename Job>
+bool run_jobs(size_t jobs, size_t count, Job&& job) {
+   std::atomic<size_t> next{0};
+   std::atomic<bool>   failed{false};
+   auto worker = [&]() {
+      for (size_t i = next++; i < count && !failed; i = next++) {
+         if (!job(i))
+            failed = true;
+      }
+   };
+
+   std::vector<std::thread> pool;
+   for (size_t t = 1; t < std::min(jobs, count); t++)
+      pool.emplace_back(worker);
+   worker();
+   for (auto& t : pool)
+      t.join();
+   return !failed;
+}
 }} // ns eosio::cdt
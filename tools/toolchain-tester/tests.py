@@ -154,8 +154,41 @@ class BuildPassTest(Test):
         res = subprocess.run(command, capture_output=True)
         self.handle_test_result(res)
 
+        if self.test_json.get("compare_flags"):
+            self.compare_outputs(eosio_cpp, args)
+
         return res
 
+    def compare_outputs(self, eosio_cpp, args):
+        """
+        Builds the test again with its compare_flags added and checks the wasm and abi are the same.
+        """
+        out_wasm = f"{self._name}_compare.wasm"
+        command = [eosio_cpp, self.cpp_file, "-o", out_wasm]
+        command.extend(args)
+        command.extend(self.test_json["compare_flags"])
+        res = subprocess.run(command, capture_output=True)
+
+        if res.returncode > 0:
+            self.success = False
+            raise TestFailure(
+                f"{self.fullname} failed with compare_flags with the following stderr {res.stderr.decode('utf-8').strip()}",
+                failing_test=self,
+            )
+
+        outputs = [(self.out_wasm, out_wasm)]
+        if os.path.exists(f"{self._name}.abi"):
+            outputs.append((f"{self._name}.abi", f"{self._name}_compare.abi"))
+
+        for expected_file, actual_file in outputs:
+            with open(expected_file, "rb") as e, open(actual_file, "rb") as a:
+                if e.read() != a.read():
+                    self.success = False
+                    raise TestFailure(
+                        f"{actual_file} built with compare_flags did not match {expected_file}",
+                        failing_test=self,
+                    )
+
 
 class CompilePassTest(Test):
     def _run(self, eosio_cpp, args):